@@ -0,0 +1,238 @@
+#include "Abundance.h"
+
+/*Fenwick (binary indexed) tree stored in tree[0..n-1]: to add 'delta' to the element 'i'
+ * */
+static void fenwick_Add(int *tree, int n, int i, int delta)
+{
+	for (i++;i<=n;i+=(i & (-i))) tree[i-1] += delta;
+
+	return;
+}
+
+/*To find the element 'i' such that (sum of the elements before i) <= r < (sum of the elements until i),
+ * with 0 <= r < (sum of all the elements)
+ * */
+static int fenwick_Find(int *tree, int n, int r)
+{
+	int pos,step;
+
+	step = 1;
+	while (step*2 <= n) step *= 2;
+	pos = 0;
+	for (;step>0;step>>=1)
+	{
+		if ((pos+step <= n) && (tree[pos+step-1] <= r))
+		{
+			pos += step;
+			r -= tree[pos-1];
+		}
+	}
+
+	return(pos);
+}
+
+Abundance::Abundance()
+{
+	this->nSites = 0;
+	this->nSpecies = 0;
+	this->nLinks = 0;
+}
+
+void Abundance::init(int nSites, int nSpecies)
+{
+	int n;
+
+	this->nSites = nSites;
+	this->nSpecies = nSpecies;
+	n = nSites*nSpecies;
+	this->nOld.assign(n,0);
+	this->nNew.assign(n,0);
+	this->nOld_ini.assign(n,0);
+	this->nNew_born.assign(n,0);
+	this->pref.assign(n,0);
+	this->reproductive_exitus.assign(n,0.0);
+	this->nInd.assign(n,0);
+	this->soc_cont.assign(n,0);
+	this->soc_bp.assign(n,0.0);
+	this->soc_dp.assign(n,0.0);
+	this->soc_mp.assign(n,0.0);
+	this->soc_ndp.assign(n,0.0);
+	this->total_Population.assign(nSites,0);
+	this->old_Total.assign(nSites,0);
+	this->site_Version.assign(nSites,1);
+	this->rate_Version.assign(n,0);//no rate is valid at the begining
+	this->rate_bp.assign(n,0.0);
+	this->rate_dp.assign(n,0.0);
+	this->rate_mp.assign(n,0.0);
+	this->rate_ndp.assign(n,0.0);
+	this->rate_cc.assign(n,0);
+	this->rate_Step.assign(n,-1);
+	this->present_Tree.assign(n,0);
+	this->present_Total.assign(nSites,0);
+	this->prey_Tree.clear();
+	this->prey_Total.clear();
+	this->predators_Offset.clear();
+
+	return;
+}
+
+/*To copy the food web and to build the trees of the preys from the current nOld. 
+ * */
+void Abundance::init_Samplers(vector<int> &preys_Offset, vector<int> &preys_Index, vector<int> &predators_Offset, vector<int> &predators_Index)
+{
+	int st,sp,k,j,q;
+	vector<int> next;
+
+	this->preys_Offset = preys_Offset;
+	this->preys_Index = preys_Index;
+	this->predators_Offset = predators_Offset;
+	this->predators_Index = predators_Index;
+	this->nLinks = (int)preys_Index.size();
+	this->predators_PreyPosition.assign(predators_Index.size(),0);
+	next.assign(this->nSpecies,0);//repeated links are matched in order
+	for (sp=0;sp<this->nSpecies;sp++)
+	{
+		for (k=predators_Offset[sp];k<predators_Offset[sp+1];k++)
+		{
+			q = predators_Index[k];
+			for (j=preys_Offset[q]+next[q];j<preys_Offset[q+1];j++)
+			{
+				if (preys_Index[j] == sp) break;
+			}
+			this->predators_PreyPosition[k] = j - preys_Offset[q];
+			next[q] = j - preys_Offset[q] + 1;
+		}
+	}
+	this->prey_Tree.assign(this->nSites*this->nLinks,0);
+	this->prey_Total.assign(this->nSites*this->nSpecies,0);
+	for (st=0;st<this->nSites;st++)
+	{
+		for (sp=0;sp<this->nSpecies;sp++)
+		{
+			for (k=predators_Offset[sp];k<predators_Offset[sp+1];k++)
+			{
+				q = predators_Index[k];
+				fenwick_Add(&this->prey_Tree[st*this->nLinks + preys_Offset[q]], preys_Offset[q+1]-preys_Offset[q], this->predators_PreyPosition[k], this->nOld[this->ix(st,sp)]);
+				this->prey_Total[this->ix(st,q)] += this->nOld[this->ix(st,sp)];
+			}
+		}
+	}
+
+	return;
+}
+
+void Abundance::set_Nold(int st, int sp, int nold)
+{
+	int i,k,q,delta;
+
+	i = this->ix(st,sp);
+	delta = nold - this->nOld[i];
+	if (delta == 0) return;
+	this->site_Version[st]++;
+	this->nInd[i] += delta;
+	this->total_Population[st] += delta;
+	this->old_Total[st] += delta;
+	if ((this->nOld[i] > 0) != (nold > 0))//the species appears or disappears from the site
+	{
+		fenwick_Add(&this->present_Tree[st*this->nSpecies], this->nSpecies, sp, (nold > 0) ? 1 : -1);
+		this->present_Total[st] += (nold > 0) ? 1 : -1;
+	}
+	if (this->predators_Offset.size())
+	{
+		for (k=this->predators_Offset[sp];k<this->predators_Offset[sp+1];k++)
+		{
+			q = this->predators_Index[k];
+			fenwick_Add(&this->prey_Tree[st*this->nLinks + this->preys_Offset[q]], this->preys_Offset[q+1]-this->preys_Offset[q], this->predators_PreyPosition[k], delta);
+			this->prey_Total[this->ix(st,q)] += delta;
+		}
+	}
+	this->nOld[i] = nold;
+
+	return;
+}
+
+/*The r-th species (0 <= r < get_NumberPresentSpecies(st)) of the site 'st' with nOld>0
+ * */
+int Abundance::get_PresentSpecies(int st, int r)
+{
+	return(fenwick_Find(&this->present_Tree[st*this->nSpecies], this->nSpecies, r));
+}
+
+/*The prey of 'pred' in the site 'st' that has the individual r (0 <= r < get_NumberIndPreys(st,pred))
+ * */
+int Abundance::get_Prey(int st, int pred, int r)
+{
+	int pos;
+
+	pos = fenwick_Find(&this->prey_Tree[st*this->nLinks + this->preys_Offset[pred]], this->preys_Offset[pred+1]-this->preys_Offset[pred], r);
+
+	return(this->preys_Index[this->preys_Offset[pred] + pos]);
+}
+
+/*To write all the arrays of the state (the food web is not written: it is the one given to init_Samplers)
+ * */
+void Abundance::save_State(Checkpoint *cp)
+{
+	cp->write_Vector(this->nOld);
+	cp->write_Vector(this->nNew);
+	cp->write_Vector(this->nOld_ini);
+	cp->write_Vector(this->nNew_born);
+	cp->write_Vector(this->pref);
+	cp->write_Vector(this->reproductive_exitus);
+	cp->write_Vector(this->nInd);
+	cp->write_Vector(this->soc_cont);
+	cp->write_Vector(this->soc_bp);
+	cp->write_Vector(this->soc_dp);
+	cp->write_Vector(this->soc_mp);
+	cp->write_Vector(this->soc_ndp);
+	cp->write_Vector(this->total_Population);
+	cp->write_Vector(this->old_Total);
+	cp->write_Vector(this->site_Version);
+	cp->write_Vector(this->rate_Version);
+	cp->write_Vector(this->rate_bp);
+	cp->write_Vector(this->rate_dp);
+	cp->write_Vector(this->rate_mp);
+	cp->write_Vector(this->rate_ndp);
+	cp->write_Vector(this->rate_cc);
+	cp->write_Vector(this->rate_Step);
+	cp->write_Vector(this->present_Tree);
+	cp->write_Vector(this->present_Total);
+	cp->write_Vector(this->prey_Tree);
+	cp->write_Vector(this->prey_Total);
+
+	return;
+}
+
+/*To read the arrays written by save_State (the checkpoint must be of the same sites and species, see Dynamic::load_Checkpoint)
+ * */
+void Abundance::load_State(Checkpoint *cp)
+{
+	cp->read_Vector(this->nOld);
+	cp->read_Vector(this->nNew);
+	cp->read_Vector(this->nOld_ini);
+	cp->read_Vector(this->nNew_born);
+	cp->read_Vector(this->pref);
+	cp->read_Vector(this->reproductive_exitus);
+	cp->read_Vector(this->nInd);
+	cp->read_Vector(this->soc_cont);
+	cp->read_Vector(this->soc_bp);
+	cp->read_Vector(this->soc_dp);
+	cp->read_Vector(this->soc_mp);
+	cp->read_Vector(this->soc_ndp);
+	cp->read_Vector(this->total_Population);
+	cp->read_Vector(this->old_Total);
+	cp->read_Vector(this->site_Version);
+	cp->read_Vector(this->rate_Version);
+	cp->read_Vector(this->rate_bp);
+	cp->read_Vector(this->rate_dp);
+	cp->read_Vector(this->rate_mp);
+	cp->read_Vector(this->rate_ndp);
+	cp->read_Vector(this->rate_cc);
+	cp->read_Vector(this->rate_Step);
+	cp->read_Vector(this->present_Tree);
+	cp->read_Vector(this->present_Total);
+	cp->read_Vector(this->prey_Tree);
+	cp->read_Vector(this->prey_Total);
+
+	return;
+}
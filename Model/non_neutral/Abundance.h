@@ -0,0 +1,102 @@
+//Class Abundance, that contains the state of all the species in all the sites, in a contiguous
+//matrix (sites x species) with one array for each field:
+//- nOld, nNew, nOld_ini, nNew_born, pref, reproductive_exitus - the same fields of tListSpecies
+//- nInd - nOld+nNew of each species in each site
+//- soc_* - the accumulators of the SOC parameters (bp, dp, mp, ndp) and the number of times they were accumulated
+//- total_Population - nOld+nNew of all the species, for each site
+//- old_Total - nOld of all the species, for each site
+//- site_Version - counter of each site, increased every time nOld, nNew or reproductive_exitus change in the site
+//- rate_* - the last SOC rates (bp, dp, mp, ndp, cc) of each species in each site, valid while
+//  rate_Version is equal to the site_Version of the site. rate_Step is the last iteration when they were used
+//- present_Tree - for each site, a Fenwick tree over the species with 1 for the species with nOld>0, to
+//  choose at random one of the species alive in the site in O(log S)
+//- prey_Tree - for each site and predator, a Fenwick tree over the preys of the predator with their
+//  nOld, to choose a prey with probability nOld/sum(nOld) in O(log(#preys))
+//
+//nOld must be changed with set_Nold, that keeps nInd, total_Population, old_Total, site_Version and the trees
+//up to date.
+//
+//save_State and load_State write and read all the arrays, except the food web (init_Samplers), in a Checkpoint.
+//
+//The arrays are ordered by species (position = sp*nSites + st), so the individuals of one
+//species along all the sites are consecutive. Each Site just keeps its row (st) and uses
+//this matrix behind its accessors.
+
+/***************************************************************************
+ *            Abundance.h
+ *
+ *  Copyright  2009  User Charles Novaes de Santana & Alejandro Rozenfeld
+ *  Email charles.santana@gmail.com / alex@ifisc.uib-csic.es
+ ****************************************************************************/
+
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _ABUNDANCE_H_
+#define _ABUNDANCE_H_
+
+#include <vector>
+#include "Checkpoint.h"
+
+using namespace::std;
+
+class Abundance
+{
+	private:
+		int nSites;
+		int nSpecies;
+		int nLinks;//number of (predator,prey) links
+		vector<int> preys_Offset, preys_Index;//the preys of each species (as in Dynamic)
+		vector<int> predators_Offset, predators_Index;//the predators of each species (as in Dynamic)
+		vector<int> predators_PreyPosition;//position of the species in the list of preys of each of its predators
+		vector<int> present_Tree, present_Total;
+		vector<int> prey_Tree, prey_Total;
+	public:
+		vector<int> nOld;
+		vector<int> nNew;
+		vector<int> nOld_ini;
+		vector<int> nNew_born;
+		vector<int> pref;
+		vector<float> reproductive_exitus;
+		vector<int> nInd;
+		vector<int> soc_cont;
+		vector<float> soc_bp, soc_dp, soc_mp, soc_ndp;
+		vector<int> total_Population;
+		vector<int> old_Total;
+		vector<unsigned int> site_Version;
+		vector<unsigned int> rate_Version;
+		vector<float> rate_bp, rate_dp, rate_mp, rate_ndp;
+		vector<int> rate_cc;
+		vector<int> rate_Step;
+		void init(int nSites, int nSpecies);
+		void init_Samplers(vector<int> &preys_Offset, vector<int> &preys_Index, vector<int> &predators_Offset, vector<int> &predators_Index);
+		void set_Nold(int st, int sp, int nold);
+		void save_State(Checkpoint *cp);
+		void load_State(Checkpoint *cp);
+		int get_NumberPresentSpecies(int st) { return(this->present_Total[st]); }
+		int get_SumOld(int st) { return(this->old_Total[st]); }
+		int get_NumberIndPreys(int st, int pred) { return(this->prey_Total.size() ? this->prey_Total[this->ix(st,pred)] : 0); }
+		int get_PresentSpecies(int st, int r);
+		int get_Prey(int st, int pred, int r);
+		int ix(int st, int sp) { return(sp*this->nSites + st); }
+		int* get_IndividualsOfSpecies(int sp) { return(&this->nInd[sp*this->nSites]); }
+		int get_NumberSites(void) { return(this->nSites); }
+		int get_NumberSpecies(void) { return(this->nSpecies); }
+		Abundance();
+		~Abundance(){};
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include "AbundanceReader.h"
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef OUTPUT_ZLIB
+#include <zlib.h>
+#endif
+
+AbundanceReader::AbundanceReader()
+{
+	memset(&this->header,0,sizeof(tAbundanceHeader));
+	this->data = NULL;
+	this->map = NULL;
+	this->map_Size = 0;
+	this->nSamples = 0;
+}
+
+AbundanceReader::~AbundanceReader()
+{
+	this->close();
+}
+
+void AbundanceReader::close(void)
+{
+	if (this->map != NULL) munmap(this->map,this->map_Size);
+	this->map = NULL;
+	this->map_Size = 0;
+	this->memory.clear();
+	this->data = NULL;
+	this->nSamples = 0;
+	return;
+}
+
+/*Returns 1 if the file was opened, 0 otherwise
+ * */
+int AbundanceReader::open(string name)
+{
+	int fd;
+	struct stat st;
+	unsigned long block;
+
+	this->close();
+	fd = ::open(name.c_str(),O_RDONLY);
+	if (fd < 0) return(0);
+	if ((fstat(fd,&st) != 0) || ((unsigned long)st.st_size < sizeof(tAbundanceHeader)) || (read(fd,&this->header,sizeof(tAbundanceHeader)) != (int)sizeof(tAbundanceHeader)) || (memcmp(this->header.magic,ABUNDANCE_MAGIC,4) != 0))
+	{
+		::close(fd);
+		return(0);
+	}
+	block = 1 + (unsigned long)this->header.nSpecies*this->header.nSites;//int32 of each sample
+	if (!this->header.compressed)
+	{
+		this->map_Size = st.st_size;
+		this->map = mmap(NULL,this->map_Size,PROT_READ,MAP_SHARED,fd,0);
+		::close(fd);
+		if (this->map == MAP_FAILED)
+		{
+			this->map = NULL;
+			return(0);
+		}
+		this->data = (const int32_t*)((const char*)this->map + sizeof(tAbundanceHeader));
+		this->nSamples = (int)((this->map_Size - sizeof(tAbundanceHeader))/(4*block));
+		if ((this->header.nSamples > 0) && (this->header.nSamples < this->nSamples)) this->nSamples = this->header.nSamples;
+		return(1);
+	}
+#ifdef OUTPUT_ZLIB
+	{
+		gzFile gz;
+		int32_t buf[4096];
+		int n;
+
+		lseek(fd,sizeof(tAbundanceHeader),SEEK_SET);
+		gz = gzdopen(fd,"rb");
+		if (gz == NULL)
+		{
+			::close(fd);
+			return(0);
+		}
+		while ((n = gzread(gz,buf,sizeof(buf))) > 0) this->memory.insert(this->memory.end(),buf,buf + n/4);
+		gzclose(gz);
+		this->data = this->memory.size() ? &this->memory[0] : NULL;
+		this->nSamples = (int)(this->memory.size()/block);
+		return(1);
+	}
+#else
+	fprintf(stderr,"THE FILE %s IS COMPRESSED: COMPILE WITH OUTPUT_ZLIB TO READ IT\n",name.c_str());
+	::close(fd);
+	return(0);
+#endif
+}
+
+int AbundanceReader::get_Iteration(int k)
+{
+	return(this->data[(unsigned long)k*(1 + (unsigned long)this->header.nSpecies*this->header.nSites)]);
+}
+
+const int32_t* AbundanceReader::get_Sample(int k)
+{
+	return(&this->data[(unsigned long)k*(1 + (unsigned long)this->header.nSpecies*this->header.nSites) + 1]);
+}
+
+int AbundanceReader::get_Individuals(int k, int sp, int st)
+{
+	return(this->get_Sample(k)[(unsigned long)sp*this->header.nSites + st]);
+}
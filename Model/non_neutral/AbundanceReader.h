@@ -0,0 +1,93 @@
+//Class AbundanceReader, to read the binary files of the time series of the individuals of each species
+//in each site (OUTPUT_BINARY layout of OutputSink), output_species_seed_S_real_R_changes_C.fwab
+//(or .fwab.gz, when the program was compiled with OUTPUT_ZLIB).
+//
+//The file is a header (tAbundanceHeader, 64 bytes) and then one block per sample, all of them with the
+//same size:
+//  int32 iteration, int32 individuals[nSpecies][nSites]
+//so the individuals of the species 'sp' in the site 'st' at the sample 'k' are at the position
+//  64 + 4*(k*(1 + nSpecies*nSites) + 1 + sp*nSites + st)
+//All the numbers are in the byte order of the machine that wrote the file.
+//
+//The uncompressed files are mapped in memory (mmap), the compressed ones are read to the memory.
+//
+//- open           - to open a file (returns 0 if it is not a valid file)
+//- get_Iteration  - the iteration of the sample k
+//- get_Sample     - the individuals of all the species in all the sites of the sample k ([sp*nSites + st])
+//- get_Individuals- the individuals of the species 'sp' in the site 'st' of the sample k
+
+/***************************************************************************
+ *            AbundanceReader.h
+ *
+ *  Copyright  2009  User Charles Novaes de Santana & Alejandro Rozenfeld
+ *  Email charles.santana@gmail.com / alex@ifisc.uib-csic.es
+ ****************************************************************************/
+
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _ABUNDANCEREADER_H_
+#define _ABUNDANCEREADER_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace::std;
+
+#define ABUNDANCE_MAGIC "FWAB"
+#define ABUNDANCE_VERSION 1
+
+typedef struct sAbundanceHeader
+{
+	char magic[4];//"FWAB"
+	int32_t version;
+	int32_t nSpecies;
+	int32_t nSites;
+	int32_t nSamples;//0 in the compressed files: the number of samples is given by the size of the data
+	int32_t seed;
+	int32_t realization;
+	int32_t changes;
+	int32_t compressed;//1 - the file after the header is compressed with zlib (gzip)
+	int32_t reserved[7];
+}tAbundanceHeader;
+
+class AbundanceReader
+{
+	private:
+		tAbundanceHeader header;
+		const int32_t *data;//the first sample
+		void *map;//the mapped file (uncompressed files)
+		unsigned long map_Size;
+		vector<int32_t> memory;//the data of the compressed files
+		int nSamples;
+		void close(void);
+	public:
+		int open(string name);
+		int get_NumberSpecies(void) { return(this->header.nSpecies); }
+		int get_NumberSites(void) { return(this->header.nSites); }
+		int get_NumberSamples(void) { return(this->nSamples); }
+		int get_Seed(void) { return(this->header.seed); }
+		int get_Realization(void) { return(this->header.realization); }
+		int get_Changes(void) { return(this->header.changes); }
+		int get_Iteration(int k);
+		const int32_t* get_Sample(int k);
+		int get_Individuals(int k, int sp, int st);
+		AbundanceReader();
+		~AbundanceReader();
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include "AllocStats.h"
+#include <new>
+#include <cstdlib>
+
+unsigned long AllocStats::total_Allocations = 0;
+unsigned long AllocStats::total_Deallocations = 0;
+unsigned long AllocStats::total_Bytes = 0;
+
+#ifdef MC_PROFILE
+void* operator new(size_t size)
+{
+	void *p;
+
+	__sync_fetch_and_add(&AllocStats::total_Allocations,1);
+	__sync_fetch_and_add(&AllocStats::total_Bytes,size);
+	p = malloc(size ? size : 1);
+	if (p == NULL) throw bad_alloc();
+
+	return(p);
+}
+
+void* operator new[](size_t size)
+{
+	return(operator new(size));
+}
+
+void operator delete(void *p) throw()
+{
+	if (p == NULL) return;
+	__sync_fetch_and_add(&AllocStats::total_Deallocations,1);
+	free(p);
+	return;
+}
+
+void operator delete[](void *p) throw()
+{
+	operator delete(p);
+	return;
+}
+
+void operator delete(void *p, size_t) throw()
+{
+	operator delete(p);
+	return;
+}
+
+void operator delete[](void *p, size_t) throw()
+{
+	operator delete(p);
+	return;
+}
+#endif
+
+AllocStats::AllocStats()
+{
+	this->take_Snapshot();
+}
+
+void AllocStats::take_Snapshot(void)
+{
+	this->allocations = AllocStats::total_Allocations;
+	this->deallocations = AllocStats::total_Deallocations;
+	this->bytes = AllocStats::total_Bytes;
+	return;
+}
+
+unsigned long AllocStats::get_Allocations(void)
+{
+	return(AllocStats::total_Allocations - this->allocations);
+}
+
+unsigned long AllocStats::get_Deallocations(void)
+{
+	return(AllocStats::total_Deallocations - this->deallocations);
+}
+
+unsigned long AllocStats::get_Bytes(void)
+{
+	return(AllocStats::total_Bytes - this->bytes);
+}
+
+void AllocStats::print_Report(ostream &out, const char *label)
+{
+	out << "ALLOCATIONS (" << label << ", ALL THE THREADS OF THE PROCESS): " << this->get_Allocations() << " NEW, " << this->get_Deallocations() << " DELETE, " << this->get_Bytes() << " BYTES" << endl;
+	return;
+}
@@ -0,0 +1,62 @@
+//Class AllocStats, that counts the allocations and deallocations of memory of the whole program
+//(the operators new and delete are replaced in AllocStats.cpp), to verify that the loop of the
+//Monte Carlo doesn't allocate memory for each event. The operators are only replaced with MC_PROFILE
+//(make PROFILE=1), because each allocation pays an atomic operation; without it the counters are 0.
+//
+//The counters are of the whole process: with several threads, or with the runs of Ensemble and Sweep
+//at the same time, the allocations of a run include the ones of the others. The number of a run is
+//exact only with OMP_NUM_THREADS=1 and one run.
+//
+//- take_Snapshot - to save the current counters
+//- print_Report  - to print the allocations done since the last snapshot
+
+/***************************************************************************
+ *            AllocStats.h
+ *
+ *  Copyright  2009  User Charles Novaes de Santana & Alejandro Rozenfeld
+ *  Email charles.santana@gmail.com / alex@ifisc.uib-csic.es
+ ****************************************************************************/
+
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _ALLOCSTATS_H_
+#define _ALLOCSTATS_H_
+
+#include <iostream>
+
+using namespace::std;
+
+class AllocStats
+{
+	private:
+		unsigned long allocations;
+		unsigned long deallocations;
+		unsigned long bytes;
+	public:
+		static unsigned long total_Allocations;
+		static unsigned long total_Deallocations;
+		static unsigned long total_Bytes;
+		void take_Snapshot(void);
+		unsigned long get_Allocations(void);
+		unsigned long get_Deallocations(void);
+		unsigned long get_Bytes(void);
+		void print_Report(ostream &out, const char *label);
+		AllocStats();
+		~AllocStats(){};
+};
+
+#endif
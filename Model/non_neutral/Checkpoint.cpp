@@ -0,0 +1,152 @@
+#include "Checkpoint.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+Checkpoint::Checkpoint()
+{
+	this->writing = 0;
+}
+
+Checkpoint::~Checkpoint()
+{
+	if (this->file.is_open()) this->file.close();
+}
+
+/*To read only the header of the checkpoint 'name'. It returns 0 if there is no checkpoint (or it is not valid)
+ * */
+int Checkpoint::read_Header(string name, tCheckpointHeader *header)
+{
+	ifstream f1;
+
+	f1.open(name.c_str(),ifstream::binary);
+	if (!f1.is_open()) return(0);
+	f1.read((char*)header,sizeof(tCheckpointHeader));
+	if ((f1.fail()) || (memcmp(header->magic,CHECKPOINT_MAGIC,4)) || (header->version != CHECKPOINT_VERSION)) return(0);
+	f1.close();
+
+	return(1);
+}
+
+int Checkpoint::open_Write(string name, tCheckpointHeader *header)
+{
+	this->name = name;
+	this->writing = 1;
+	memcpy(header->magic,CHECKPOINT_MAGIC,4);
+	header->version = CHECKPOINT_VERSION;
+	this->file.open((name + ".tmp").c_str(),fstream::out | fstream::binary | fstream::trunc);
+	if (!this->file.is_open()) return(0);
+	this->file.write((const char*)header,sizeof(tCheckpointHeader));
+
+	return(this->is_Good());
+}
+
+int Checkpoint::open_Read(string name, tCheckpointHeader *header)
+{
+	this->name = name;
+	this->writing = 0;
+	this->file.open(name.c_str(),fstream::in | fstream::binary);
+	if (!this->file.is_open()) return(0);
+	this->file.read((char*)header,sizeof(tCheckpointHeader));
+	if ((this->file.fail()) || (memcmp(header->magic,CHECKPOINT_MAGIC,4)) || (header->version != CHECKPOINT_VERSION)) return(0);
+
+	return(1);
+}
+
+/*To finish the checkpoint. A checkpoint that was written replaces the previous one only if all the writes were good
+ * */
+int Checkpoint::close(void)
+{
+	int good;
+
+	good = this->is_Good();
+	this->file.close();
+	if (this->writing)
+	{
+		if (good) good = (rename((this->name + ".tmp").c_str(),this->name.c_str()) == 0);
+		else remove((this->name + ".tmp").c_str());
+	}
+
+	return(good);
+}
+
+void Checkpoint::write_Int(int value)
+{
+	int32_t v;
+
+	v = value;
+	this->file.write((const char*)&v,sizeof(int32_t));
+
+	return;
+}
+
+int Checkpoint::read_Int(void)
+{
+	int32_t v;
+
+	v = 0;
+	this->file.read((char*)&v,sizeof(int32_t));
+
+	return((int)v);
+}
+
+void Checkpoint::write_String(string value)
+{
+	this->write_Int((int)value.size());
+	this->file.write(value.data(),value.size());
+
+	return;
+}
+
+string Checkpoint::read_String(void)
+{
+	int n;
+	string value;
+
+	n = this->read_Int();
+	if ((n < 0) || (this->file.fail()))
+	{
+		this->file.setstate(ios::failbit);
+		return(value);
+	}
+	value.resize(n);
+	if (n) this->file.read(&value[0],n);
+
+	return(value);
+}
+
+/*To save the name and the current size of an output file (-1 if it doesn't exist)
+ * */
+void Checkpoint::write_FileSize(string name)
+{
+	struct stat st;
+	int64_t size;
+
+	this->write_String(name);
+	if (stat(name.c_str(),&st) == 0) size = st.st_size;
+	else size = -1;
+	this->file.write((const char*)&size,sizeof(int64_t));
+
+	return;
+}
+
+/*To cut the next file of the checkpoint to the size it had when the checkpoint was written (or to remove
+ * it, if it didn't exist). It returns the name of the file
+ * */
+string Checkpoint::restore_FileSize(void)
+{
+	string name;
+	int64_t size;
+	struct stat st;
+
+	name = this->read_String();
+	size = -1;
+	this->file.read((char*)&size,sizeof(int64_t));
+	if ((this->file.fail()) || (stat(name.c_str(),&st) != 0)) return(name);
+	if (size < 0) remove(name.c_str());
+	else if (st.st_size > size) truncate(name.c_str(),size);
+
+	return(name);
+}
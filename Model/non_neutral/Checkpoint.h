@@ -0,0 +1,113 @@
+//Class Checkpoint, a binary file with the whole state of a Dynamic at the end of one iteration of the
+//Monte Carlo, so a run that was stopped can continue from there (see Dynamic::save_Checkpoint and
+//Dynamic::load_Checkpoint) and write exactly the same files of a run without stops.
+//
+//The file is a header (tCheckpointHeader) and then the state of the Dynamic, the Species, the Sites,
+//the Abundance, the OutputSink and the FlowRecorder, each vector as [int32 size][the elements]. The header keeps the
+//parameters of the run, to refuse a checkpoint of another run.
+//
+//The file is first written as NAME.tmp and then renamed, so a stop while writing never leaves a broken
+//checkpoint. The output files that are written with 'append' are saved with their sizes (write_FileSize):
+//when the checkpoint is read they are cut to that size, to remove what was written after the checkpoint.
+
+/***************************************************************************
+ *            Checkpoint.h
+ *
+ *  Copyright  2009  User Charles Novaes de Santana & Alejandro Rozenfeld
+ *  Email charles.santana@gmail.com / alex@ifisc.uib-csic.es
+ ****************************************************************************/
+
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace::std;
+
+#define CHECKPOINT_MAGIC "FWCK"
+#define CHECKPOINT_VERSION 5
+
+typedef struct sCheckpointHeader
+{
+	char magic[4];//"FWCK"
+	int32_t version;
+	int32_t seed;
+	int32_t realization;
+	int32_t changes;
+	int32_t timestep;//the last iteration done: the run continues at timestep+1
+	int32_t nSpecies;
+	int32_t nSites;
+	int32_t niter, tm, tcn, show_each, save_each;
+	float existence_threshold;
+	int32_t engine;//ENGINE_EXACT, ENGINE_TAULEAP or ENGINE_GILLESPIE
+	int32_t migration;//MIGRATION_SEQUENTIAL or MIGRATION_TWOPHASE
+}tCheckpointHeader;
+
+class Checkpoint
+{
+	private:
+		string name;
+		fstream file;
+		int writing;
+	public:
+		static int read_Header(string name, tCheckpointHeader *header);
+		int open_Write(string name, tCheckpointHeader *header);
+		int open_Read(string name, tCheckpointHeader *header);
+		int close(void);
+		void write_Int(int value);
+		int read_Int(void);
+		void write_String(string value);
+		string read_String(void);
+		void write_FileSize(string name);
+		string restore_FileSize(void);
+		int is_Good(void) { return(!this->file.fail()); }
+		template<class T> void write_Vector(vector<T> &v);
+		template<class T> void read_Vector(vector<T> &v);
+		Checkpoint();
+		~Checkpoint();
+};
+
+template<class T> void Checkpoint::write_Vector(vector<T> &v)
+{
+	this->write_Int((int)v.size());
+	if (v.size()) this->file.write((const char*)&v[0],v.size()*sizeof(T));
+
+	return;
+}
+
+template<class T> void Checkpoint::read_Vector(vector<T> &v)
+{
+	int n;
+
+	n = this->read_Int();
+	if ((n < 0) || (this->file.fail()))
+	{
+		this->file.setstate(ios::failbit);
+		return;
+	}
+	v.resize(n);
+	if (n) this->file.read((char*)&v[0],n*sizeof(T));
+
+	return;
+}
+
+#endif
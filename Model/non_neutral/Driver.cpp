@@ -0,0 +1,63 @@
+#include "Driver.h"
+
+Driver::Driver(int niter, int tm, int tcn, int seed, char *fwnf, char *snnf, int show_each, int save_each)
+{
+	this->niter = niter;
+	this->tm = tm;
+	this->tcn = tcn;
+	this->seed = seed;
+	this->fwnf = fwnf;
+	this->snnf = snnf;
+	this->show_each = show_each;
+	this->save_each = save_each;
+	this->structure = NULL;
+}
+
+Driver::~Driver()
+{
+	if (this->structure != NULL) delete(this->structure);
+}
+
+/*To read the food web and the landscape, only once for all the runs
+ * */
+void Driver::load_Structure(void)
+{
+	this->structure = new Dynamic(this->niter,this->tm,this->tcn,this->seed,this->fwnf,this->snnf,this->show_each,this->save_each);
+	this->structure->load_Structure();
+
+	return;
+}
+
+/*A Dynamic of 'seed' with a copy of the food web and the landscape (to be deleted by who asked for it, or by
+ * run_Summary)
+ * */
+Dynamic* Driver::new_Run(int seed)
+{
+	Dynamic *d1;
+
+	d1 = new Dynamic(this->niter,this->tm,this->tcn,seed,this->fwnf,this->snnf,this->show_each,this->save_each);
+	d1->copy_Structure(this->structure);
+
+	return(d1);
+}
+
+/*To run 'd1' (from new_Run, with its parameters already changed) once, without output files nor messages, and to
+ * delete it. 'summary' gets LAST_ITERATION_ALL_ALIVE and the individuals of each species at the end
+ * */
+void Driver::run_Summary(Dynamic *d1, vector<int> *summary)
+{
+	int sp,nSpecies;
+	ofstream nolog;//never opened: the messages of the Monte Carlo are discarded
+
+	d1->set_WriteFiles(0);
+	d1->set_Log(&nolog);
+	d1->init_Components(0);
+	d1->MonteCarlo(1,0);
+	nSpecies = d1->get_NumberSpeciesFoodWeb();
+	summary->resize(nSpecies+1);
+	summary->at(0) = d1->get_LastIterationAllAlive();
+	for (sp=0;sp<nSpecies;sp++) summary->at(sp+1) = d1->get_TotalIndividuals(sp);
+	delete(d1);
+
+	return;
+}
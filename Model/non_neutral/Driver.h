@@ -0,0 +1,51 @@
+//Class Driver, the base of the classes that run many simulations in only one process (Ensemble, Sweep and
+//EngineCheck):
+//- the food web (FWNF) and the landscape (SNNF) are read only once, in 'structure' (load_Structure), and each
+//  run copies them (new_Run, with Dynamic::copy_Structure)
+//- run_Summary runs a Dynamic without output files nor messages and keeps what the runs are compared by:
+//  LAST_ITERATION_ALL_ALIVE INDIVIDUALS_SP1 ... INDIVIDUALS_SPn (LAST_ITERATION_ALL_ALIVE is what
+//  print_StabilityAnalisys records, INDIVIDUALS are nOld+nNew of the species in all the sites at the end)
+
+/***************************************************************************
+ *            Driver.h
+ *
+ *  Copyright  2009  User Charles Novaes de Santana & Alejandro Rozenfeld
+ *  Email charles.santana@gmail.com / alex@ifisc.uib-csic.es
+ ****************************************************************************/
+
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _DRIVER_H_
+#define _DRIVER_H_
+
+#include "Dynamic.h"
+
+class Driver
+{
+	protected:
+		int niter, tm, tcn, seed, show_each, save_each;
+		char *fwnf, *snnf;
+		Dynamic *structure;//just to keep the food web and the landscape read from the files
+		void load_Structure(void);
+		Dynamic* new_Run(int seed);
+		void run_Summary(Dynamic *d1, vector<int> *summary);
+	public:
+		Driver(int niter, int tm, int tcn, int seed, char *fwnf, char *snnf, int show_each, int save_each);
+		virtual ~Driver();
+};
+
+#endif
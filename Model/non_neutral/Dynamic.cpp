@@ -1,4 +1,8 @@
 #include "Dynamic.h"
+#include <string.h>
+
+int Dynamic::default_Engine = MC_ENGINE;
+int Dynamic::default_Migration = MC_MIGRATION;
 
 Dynamic::Dynamic(int niter, int tm, int tcn, int seed, char* fwnf, char* snnf, int show_each, int save_each)
 {
@@ -10,6 +14,15 @@ Dynamic::Dynamic(int niter, int tm, int tcn, int seed, char* fwnf, char* snnf, i
 	this->save_each = save_each;
 	this->name_FWNF.assign(fwnf);
 	this->name_SNNF.assign(snnf);
+	this->dir_Output.assign("");
+	this->out_Log = &cerr;
+	this->write_Files = 1;
+	this->coexistence_Layout = COEXISTENCE_LAYOUT;
+	this->coexistence_Threshold = COEXISTENCE_THRESHOLD;
+	this->write_Checkpoints = 1;
+	this->first_Timestep = 0;
+	this->engine = Dynamic::default_Engine;
+	this->migration = Dynamic::default_Migration;
 }
 
 Dynamic::~Dynamic()
@@ -24,49 +37,369 @@ void Dynamic::init_Components(int cont)
 {
 	int st;
 
-	if (cont == 0)
+	if (this->_Species.empty())//the food web and the landscape weren't read yet (or copied with copy_Structure)
 	{
-		this->init_Species();
-		this->init_Sites();
+		this->load_Structure();
 	}
+	this->rng.set_Seed(this->seed,cont,0);//each realization has its own streams, given by the SEED
 	for (st=0;st<(int)this->_Sites.size();st++)
 	{
+		this->_Sites.at(st).get_Random()->set_Seed(this->seed,cont,st+1);
 		this->init_Individuals(st,this->_Species.size(),cont);
 	}
 
 	return;
 }
 
-void Dynamic::init_Species(void)
+/*To read the food web (FWNF) and the landscape (SNNF)
+ * */
+void Dynamic::load_Structure(void)
 {
-	int i,j,nVert,id,nIni;
-	float bp,dp,ndp,mp;
-	string name;
-	ifstream f1;
-	Species *sp;
-	string line,ci,cj;
-	
-	f1.open(this->name_FWNF.c_str());
-	if (f1 == NULL)
+	this->init_Species();
+	this->init_Sites();
+
+	return;
+}
+
+/*To copy the food web and the landscape already read by another Dynamic, instead of reading the files again.
+ * 'from' is only read, so many Dynamics can copy the same one at the same time.
+ * */
+void Dynamic::copy_Structure(Dynamic *from)
+{
+	int st;
+
+	this->_Species = from->_Species;
+	this->preys_Offset = from->preys_Offset;
+	this->preys_Index = from->preys_Index;
+	this->predators_Offset = from->predators_Offset;
+	this->predators_Index = from->predators_Index;
+	this->pref_Offset = from->pref_Offset;
+	this->pref_Index = from->pref_Index;
+	this->pref_Sign = from->pref_Sign;
+	this->neigh_Offset = from->neigh_Offset;
+	this->neigh_Index = from->neigh_Index;
+	this->neigh_Weight = from->neigh_Weight;
+	this->neigh_Source = from->neigh_Source;
+	this->neigh_InOffset = from->neigh_InOffset;
+	this->neigh_InEdge = from->neigh_InEdge;
+	this->_Sites = from->_Sites;
+	this->sitesOrdered = from->sitesOrdered;
+	this->_Abundance.init((int)this->_Sites.size(),(int)this->_Species.size());
+	this->_Abundance.init_Samplers(this->preys_Offset,this->preys_Index,this->predators_Offset,this->predators_Index);
+	for (st=0;st<(int)this->_Sites.size();st++)
+	{
+		this->_Sites.at(st).set_Abundance(&this->_Abundance);
+	}
+
+	return;
+}
+
+/*All the output files of this Dynamic are written in the directory 'dir' (that must exist)
+ * */
+void Dynamic::set_OutputDirectory(string dir)
+{
+	this->dir_Output = dir;
+	if ((this->dir_Output.size() > 0) && (this->dir_Output.at(this->dir_Output.size()-1) != '/')) this->dir_Output += "/";
+	return;
+}
+
+/*The messages of the Monte Carlo (iterations, allocations) go to 'log' (cerr by default)
+ * */
+void Dynamic::set_Log(ostream *log)
+{
+	this->out_Log = log;
+	return;
+}
+
+string Dynamic::get_OutputName(string name)
+{
+	return(this->dir_Output + name);
+}
+
+/*The layout of the files of the time series of print_File (OUTPUT_PER_SPECIES, OUTPUT_COMBINED or OUTPUT_BINARY, see OutputSink)
+ * */
+void Dynamic::set_OutputLayout(int layout)
+{
+	this->_Output.set_Layout(layout);
+	return;
+}
+
+/*The files of CoexistenceNetworks: COEXISTENCE_TABLE, COEXISTENCE_PAJEK or both (COEXISTENCE_TABLE|COEXISTENCE_PAJEK).
+ * The pairs of species with all the weights <= 'threshold' are not written in the table.
+ * */
+void Dynamic::set_CoexistenceLayout(int layout, float threshold)
+{
+	this->coexistence_Layout = layout;
+	this->coexistence_Threshold = threshold;
+	return;
+}
+
+/*With 'write' = 0 the Monte Carlo doesn't write checkpoints (see save_Checkpoint)
+ * */
+void Dynamic::set_Checkpoints(int write)
+{
+	this->write_Checkpoints = write;
+	return;
+}
+
+/*ENGINE_EXACT (the default, MC_ENGINE), ENGINE_TAULEAP, ENGINE_GILLESPIE or ENGINE_MEANFIELD
+ * */
+void Dynamic::set_Engine(int engine)
+{
+	this->engine = engine;
+	return;
+}
+
+/*The engine of a name of the command line (exact, tauleap, gillespie or meanfield), 0 if it is not one of them
+ * */
+int Dynamic::get_Engine(string name)
+{
+	if (name == "exact") return(ENGINE_EXACT);
+	if (name == "tauleap") return(ENGINE_TAULEAP);
+	if (name == "gillespie") return(ENGINE_GILLESPIE);
+	if (name == "meanfield") return(ENGINE_MEANFIELD);
+
+	return(0);
+}
+
+string Dynamic::get_EngineName(int engine)
+{
+	if (engine == ENGINE_TAULEAP) return("tauleap");
+	if (engine == ENGINE_GILLESPIE) return("gillespie");
+	if (engine == ENGINE_MEANFIELD) return("meanfield");
+
+	return("exact");
+}
+
+/*MIGRATION_SEQUENTIAL (the default, MC_MIGRATION) or MIGRATION_TWOPHASE
+ * */
+void Dynamic::set_Migration(int migration)
+{
+	this->migration = migration;
+	return;
+}
+
+/*The mode of Migration of a name of the command line (sequential or twophase), 0 if it is not one of them
+ * */
+int Dynamic::get_Migration(string name)
+{
+	if (name == "sequential") return(MIGRATION_SEQUENTIAL);
+	if (name == "twophase") return(MIGRATION_TWOPHASE);
+
+	return(0);
+}
+
+string Dynamic::get_CheckpointName(void)
+{
+	ostringstream os1;
+
+	os1 << "checkpoint_seed_" << this->seed << ".chk";
+	return(this->get_OutputName(os1.str()));
+}
+
+void Dynamic::fill_CheckpointHeader(tCheckpointHeader *header, int realization, int changes)
+{
+	memset(header,0,sizeof(tCheckpointHeader));
+	header->seed = this->seed;
+	header->realization = realization;
+	header->changes = changes;
+	header->timestep = this->mc_timestep;
+	header->nSpecies = (int)this->_Species.size();
+	header->nSites = (int)this->_Sites.size();
+	header->niter = this->niter;
+	header->tm = this->tm;
+	header->tcn = this->tcn;
+	header->show_each = this->show_each;
+	header->save_each = this->save_each;
+	header->existence_threshold = Site::existence_threshold;
+	header->engine = this->engine;
+	header->migration = this->migration;
+
+	return;
+}
+
+/*To write the state of the Monte Carlo at the end of the iteration mc_timestep, so load_Checkpoint can continue the
+ * run from the next iteration. The files written in 'append' mode are saved with their sizes.
+ * */
+void Dynamic::save_Checkpoint(int realization, int changes)
+{
+	int sp,st;
+	Checkpoint cp;
+	tCheckpointHeader header;
+	vector<uint64_t> state(4);
+
+	this->fill_CheckpointHeader(&header,realization,changes);
+	if (!cp.open_Write(this->get_CheckpointName(),&header))
+	{
+		*this->out_Log << "IT WAS NOT POSSIBLE TO WRITE THE CHECKPOINT " << this->get_CheckpointName() << endl;
+		return;
+	}
+	this->rng.get_State(&state[0]);
+	cp.write_Vector(state);
+	cp.write_Vector(this->sitesOrdered);
+	cp.write_Vector(this->list_StabilityAnalisys);
+	for (sp=0;sp<(int)this->_Species.size();sp++) this->_Species.at(sp).save_State(&cp);
+	for (st=0;st<(int)this->_Sites.size();st++) this->_Sites.at(st).save_State(&cp);
+	this->_Abundance.save_State(&cp);
+	this->_Output.save_State(&cp);
+	this->_Flows.save_State(&cp);
+	for (sp=0;sp<(int)this->_Species.size();sp++) cp.write_FileSize(this->get_OutputName(this->get_SOCName(sp,realization)));
+	if (!cp.close()) *this->out_Log << "IT WAS NOT POSSIBLE TO WRITE THE CHECKPOINT " << this->get_CheckpointName() << endl;
+
+	return;
+}
+
+/*To read the checkpoint of (realization, changes), after init_Components, so the next MonteCarlo continues from
+ * the iteration after the checkpoint. It returns 0 if there is no checkpoint of this realization
+ * */
+int Dynamic::load_Checkpoint(int realization, int changes)
+{
+	int sp,st;
+	Checkpoint cp;
+	tCheckpointHeader header, expected;
+	vector<uint64_t> state;
+
+	if (!cp.open_Read(this->get_CheckpointName(),&header)) return(0);
+	this->fill_CheckpointHeader(&expected,realization,changes);
+	if ((header.seed != expected.seed) || (header.realization != expected.realization) || (header.changes != expected.changes) || (header.nSpecies != expected.nSpecies) || (header.nSites != expected.nSites) || (header.niter != expected.niter) || (header.tm != expected.tm) || (header.tcn != expected.tcn) || (header.show_each != expected.show_each) || (header.save_each != expected.save_each) || (header.existence_threshold != expected.existence_threshold) || (header.engine != expected.engine) || (header.migration != expected.migration))
 	{
-		cerr << "FILE " << this->name_FWNF << " DOESN'T EXIST!" << endl;
+		cerr << "THE CHECKPOINT " << this->get_CheckpointName() << " IS OF ANOTHER RUN!" << endl;
 		exit(1);
 	}
-	f1 >> name >> nVert;
-	for (i=0;i<nVert;i++)
+	cp.read_Vector(state);
+	if (state.size() == 4) this->rng.set_State(&state[0]);
+	cp.read_Vector(this->sitesOrdered);
+	cp.read_Vector(this->list_StabilityAnalisys);
+	for (sp=0;sp<(int)this->_Species.size();sp++) this->_Species.at(sp).load_State(&cp);
+	for (st=0;st<(int)this->_Sites.size();st++) this->_Sites.at(st).load_State(&cp);
+	this->_Abundance.load_State(&cp);
+	this->_Output.load_State(&cp);
+	this->_Flows.load_State(&cp);
+	for (sp=0;sp<(int)this->_Species.size();sp++) cp.restore_FileSize();
+	if (!cp.is_Good())
+	{
+		cerr << "THE CHECKPOINT " << this->get_CheckpointName() << " IS BROKEN!" << endl;
+		exit(1);
+	}
+	cp.close();
+	this->first_Timestep = header.timestep + 1;
+
+	return(1);
+}
+
+/*With 'write' = 0 the Monte Carlo doesn't write any output file (just the memory of the Species is kept, 
+ * see get_LastIterationAllAlive and get_TotalIndividuals)
+ * */
+void Dynamic::set_WriteFiles(int write)
+{
+	this->write_Files = write;
+	return;
+}
+
+/*To set the parameter 'p' (the same codes of SpaceOfParameters) of the species 'sp' to 'value'
+ * */
+void Dynamic::set_ParameterSpecies(int p, int sp, float value)
+{
+	switch (p)
+	{
+		case 1://birth
+		{
+			this->_Species.at(sp).set_BirthProbability(value);
+			break;
+		}
+		case 2://death
+		{
+			this->_Species.at(sp).set_DeathProbability(value);
+			break;
+		}
+		case 3://natural death
+		{
+			this->_Species.at(sp).set_NaturalDeathProbability(value);
+			break;
+		}
+		case 4://migration
+		{
+			this->_Species.at(sp).set_MigrationProbability(value);
+			break;
+		}
+		case 5://number
+		{
+			this->_Species.at(sp).set_NumberInitialIndividuals((int)value);
+			break;
+		}
+		default:
+		{
+			cerr << "WRONG PARAMETER: " << p << "! PROGRAM WILL DO NOTHING!" << endl;
+			break;
+		}
+	}
+	return;
+}
+
+void Dynamic::init_Species(void)
+{
+	int i,k;
+	NetworkFile n1;
+	const tFoodWebVertex *v;
+	const tNetworkEdge *e;
+	Species *sp;
+	
+	if (!n1.open(this->name_FWNF,NETWORK_FOODWEB)) exit(1);//text or binary (see NetworkFile)
+	for (i=0;i<n1.get_NumberVertices();i++)
 	{
-		f1 >> id >> name >> bp >> dp >> ndp >> mp >> nIni;
-		sp = new Species(id,bp,dp,ndp,mp,nIni,this->niter);
+		v = n1.get_FoodWebVertex(i);
+		sp = new Species(v->id,v->bp,v->dp,v->ndp,v->mp,v->nIni,this->niter);
 		this->_Species.push_back(*sp);
 		delete(sp);
 	}
-	f1 >> name;
-	while(f1 >> i >> j)
+	for (k=0;k<n1.get_NumberEdges();k++)
 	{
-		this->_Species.at(i-1).add_Prey(j);
-		this->_Species.at(j-1).add_Predator(i);
+		e = n1.get_Edge(k);
+		this->_Species.at(e->i-1).add_Prey(e->j);
+		this->_Species.at(e->j-1).add_Predator(e->i);
+	}
+	this->init_TrophicIndex();
+
+	return;
+}
+
+/*To build the compressed lists of preys and predators of each species, with the 
+ * indexes (id-1) of the species, so the sums over preys/predators of a species go 
+ * straight to the positions of the site instead of looking for the id of each one.
+ * */
+void Dynamic::init_TrophicIndex(void)
+{
+	int sp,i,nSpe;
+
+	nSpe = (int)this->_Species.size();
+	this->preys_Offset.assign(nSpe+1,0);
+	this->predators_Offset.assign(nSpe+1,0);
+	this->preys_Index.clear();
+	this->predators_Index.clear();
+	for (sp=0;sp<nSpe;sp++)
+	{
+		for (i=0;i<this->_Species.at(sp).get_NumberPreys();i++) this->preys_Index.push_back(this->_Species.at(sp).get_Preys(i)-1);
+		for (i=0;i<this->_Species.at(sp).get_NumberPredators();i++) this->predators_Index.push_back(this->_Species.at(sp).get_Predators(i)-1);
+		this->preys_Offset.at(sp+1) = (int)this->preys_Index.size();
+		this->predators_Offset.at(sp+1) = (int)this->predators_Index.size();
+	}
+	this->pref_Offset.assign(nSpe+1,0);
+	this->pref_Index.clear();
+	this->pref_Sign.clear();
+	for (sp=0;sp<nSpe;sp++)
+	{
+		for (i=this->preys_Offset[sp];i<this->preys_Offset[sp+1];i++)
+		{
+			this->pref_Index.push_back(this->preys_Index[i]);
+			this->pref_Sign.push_back(1);
+		}
+		for (i=this->predators_Offset[sp];i<this->predators_Offset[sp+1];i++)
+		{
+			this->pref_Index.push_back(this->predators_Index[i]);
+			this->pref_Sign.push_back(-1);
+		}
+		this->pref_Offset.at(sp+1) = (int)this->pref_Index.size();
 	}
-	f1.close();
 
 	return;
 }
@@ -207,36 +540,69 @@ void Dynamic::SpaceOfParameters(int p, vector<int> *ind_sp, int direction, int s
 
 void Dynamic::init_Sites(void)
 {
-	ifstream f1;
-	int i,j,nVert,id,weight,cc;
-	string name;
+	int i,k,nVert;
+	NetworkFile n1;
+	const tLandscapeVertex *v;
+	const tNetworkEdge *e;
 	Site *st;
 
-	f1.open(this->name_SNNF.c_str());
-	if (f1 == NULL)
-	{
-		cerr << "FILE " << this->name_SNNF << " DOESN'T EXIST!" << endl;
-		exit(1);
-	}
-	f1 >> name >> nVert;
+	if (!n1.open(this->name_SNNF,NETWORK_LANDSCAPE)) exit(1);//text or binary (see NetworkFile)
+	nVert = n1.get_NumberVertices();
+	this->_Abundance.init(nVert,(int)this->_Species.size());
+	this->_Abundance.init_Samplers(this->preys_Offset,this->preys_Index,this->predators_Offset,this->predators_Index);
 	for (i=0;i<nVert;i++)
 	{
-		f1 >> id >> name >> cc;
-		st = new Site(id,cc);
+		v = n1.get_LandscapeVertex(i);
+		st = new Site(v->id,v->cc,&this->_Abundance,i);
 		this->_Sites.push_back(*st);
-		this->sitesOrdered.push_back(id);
+		this->sitesOrdered.push_back(v->id);
 		delete(st);
 	}
-	f1 >> name;
-	while(f1 >> i >> j >> weight)
+	for (k=0;k<n1.get_NumberEdges();k++)
 	{
-		this->_Sites.at(i-1).set_Neighborhood(j,weight);
+		e = n1.get_Edge(k);
+		this->_Sites.at(e->i-1).set_Neighborhood(e->j,e->weight);
 	}
-	f1.close();
+	this->init_NeighborIndex();
 	
 	return;
 }
 
+/*The neighbors of the sites in CSR (neigh_Offset, neigh_Index, neigh_Weight), in the order of the file, for the
+ * loops of the migrations, and the edges that arrive at each site (neigh_InOffset, neigh_InEdge)
+ * */
+void Dynamic::init_NeighborIndex(void)
+{
+	int st,k,nSit;
+	tNeighborhood aux;
+	vector<int> next;
+
+	nSit = (int)this->_Sites.size();
+	this->neigh_Offset.assign(nSit+1,0);
+	this->neigh_Index.clear();
+	this->neigh_Weight.clear();
+	this->neigh_Source.clear();
+	for (st=0;st<nSit;st++)
+	{
+		for (k=0;k<this->_Sites.at(st).get_NumberNeigh();k++)
+		{
+			aux = this->_Sites.at(st).get_NeighborhoodData(k);
+			this->neigh_Index.push_back(aux.id-1);
+			this->neigh_Weight.push_back(aux.weight);
+			this->neigh_Source.push_back(st);
+		}
+		this->neigh_Offset.at(st+1) = (int)this->neigh_Index.size();
+	}
+	this->neigh_InOffset.assign(nSit+1,0);
+	for (k=0;k<(int)this->neigh_Index.size();k++) this->neigh_InOffset.at(this->neigh_Index.at(k)+1)++;
+	for (st=0;st<nSit;st++) this->neigh_InOffset.at(st+1) += this->neigh_InOffset.at(st);
+	next.assign(this->neigh_InOffset.begin(),this->neigh_InOffset.end()-1);
+	this->neigh_InEdge.assign(this->neigh_Index.size(),0);
+	for (k=0;k<(int)this->neigh_Index.size();k++) this->neigh_InEdge.at(next.at(this->neigh_Index.at(k))++) = k;
+
+	return;
+}
+
 void Dynamic::init_Individuals(int nst, int nsp, int cont)
 {
 	int i;
@@ -264,7 +630,7 @@ cambia por *
 
   iniInds = this->_Species.at(i).get_NumberInitialIndividuals();	
   
-  aux.nOld = floor(iniInds * (float)(random()%PRECISION)/PRECISION);
+  aux.nOld = floor(iniInds * this->_Sites.at(nst).get_RandomProbability());
   aux.nOld_ini=aux.nOld;
   //+++ALE
 		aux.nNew = 0;
@@ -350,34 +716,52 @@ float Dynamic::SOC_NDP(int sp, int st)
 	return(NDp);
 }
 */
-float Dynamic::SOC_NDP(int sp, int st)
+/*To calculate, in just one loop over the preys and one over the predators of 'sp', 
+ * all the sums of densities used by SOC_BP, SOC_DP, SOC_NDP and SOC_CC.
+ * */
+void Dynamic::calc_SOC_Densities(int sp, int st, tSOC_Densities *dens)
 {
-	int num_SpeciesPreys, num_SpeciesPredators;
-	int num_Species,prey,pred,i;
-	float d_prey, d_pred, d_predOfprey, d_sp, d_total_pred;
-	float dx,dy,Dp;
-	int countAux;
-		
-	num_Species = this->get_NumberSpecies();
-	num_SpeciesPreys = this->_Species.at(sp).get_NumberPreys();	
-	num_SpeciesPredators = this->_Species.at(sp).get_NumberPredators();
-	dx=0.0;	
-	for (i=0;i<num_SpeciesPreys;i++)
+	int i;
+	float d_prey, d_predOfprey;
+
+	dens->bx = 0.0;
+	dens->dx = 0.0;
+	dens->d_prey = 0.0;
+	dens->d_predOfprey = 0.0;
+	dens->dy = 0.0;
+	for (i=this->preys_Offset[sp];i<this->preys_Offset[sp+1];i++)
 	{
-		prey = this->_Species.at(sp).get_Preys(i);//the id of the prey
-		d_prey = this->_Sites.at(st).get_Density(prey-1);//the density of the prey
-		d_predOfprey = this->get_DensityPredOfPrey(st,prey-1);
-		dx += (d_predOfprey*(1-d_prey));
+		d_prey = this->_Sites.at(st).get_Density(this->preys_Index[i]);//the density of the prey
+		d_predOfprey = this->get_DensityPredOfPrey(st,this->preys_Index[i]);
+		dens->bx += d_prey*(1.0-d_predOfprey);
+		dens->dx += (d_predOfprey*(1-d_prey));
+		dens->d_prey += d_prey;
+		dens->d_predOfprey += d_predOfprey;
 	}
-	dy =0.0;
-	d_total_pred = 0.0;
-	for (i=0;i<num_SpeciesPredators;i++)
+	for (i=this->predators_Offset[sp];i<this->predators_Offset[sp+1];i++)
 	{
-		pred = this->_Species.at(sp).get_Predators(i);//the id of the predator
-		d_pred = this->_Sites.at(st).get_Density(pred-1);//the density of the predator
-		d_total_pred += d_pred;
-		dy += (d_pred); 
+		dens->dy += this->_Sites.at(st).get_Density(this->predators_Index[i]);//the density of the predator
 	}
+
+	return;
+}
+
+float Dynamic::SOC_NDP(int sp, int st)
+{
+	tSOC_Densities dens;
+
+	this->calc_SOC_Densities(sp,st,&dens);
+
+	return(this->SOC_NDP(sp,st,&dens));
+}
+
+float Dynamic::SOC_NDP(int sp, int st, tSOC_Densities *dens)
+{
+	int num_SpeciesPredators;
+	float dx,Dp;
+		
+	num_SpeciesPredators = this->_Species.at(sp).get_NumberPredators();
+	dx = dens->dx;
 	
 // 	Dp=1.0;	
 	float proportion = this->_Sites.at(st).get_Density(sp);
@@ -399,33 +783,23 @@ float Dynamic::SOC_NDP(int sp, int st)
 
 
 float Dynamic::SOC_DP(int sp, int st)
+{
+	tSOC_Densities dens;
+
+	this->calc_SOC_Densities(sp,st,&dens);
+
+	return(this->SOC_DP(sp,st,&dens));
+}
+
+float Dynamic::SOC_DP(int sp, int st, tSOC_Densities *dens)
 {
 	int num_SpeciesPreys, num_SpeciesPredators;
-	int num_Species,prey,pred,i;
-	float d_prey, d_pred, d_predOfprey, d_sp, d_total_pred;
 	float dx,dy,Dp;
-	int countAux;
 		
-	num_Species = this->get_NumberSpecies();
 	num_SpeciesPreys = this->_Species.at(sp).get_NumberPreys();	
 	num_SpeciesPredators = this->_Species.at(sp).get_NumberPredators();
-	dx=0.0;	
-	for (i=0;i<num_SpeciesPreys;i++)
-	{
-		prey = this->_Species.at(sp).get_Preys(i);//the id of the prey
-		d_prey = this->_Sites.at(st).get_Density(prey-1);//the density of the prey
-		d_predOfprey = this->get_DensityPredOfPrey(st,prey-1);
-		dx += (d_predOfprey*(1-d_prey));
-	}
-	dy =0.0;
-	d_total_pred = 0.0;
-	for (i=0;i<num_SpeciesPredators;i++)
-	{
-		pred = this->_Species.at(sp).get_Predators(i);//the id of the predator
-		d_pred = this->_Sites.at(st).get_Density(pred-1);//the density of the predator
-		d_total_pred += d_pred;
-		dy += (d_pred);
-	}
+	dx = dens->dx;
+	dy = dens->dy;
 /*	d_sp = this->_Sites.at(st).get_Density(sp);
 	dy = dy*d_sp;*/  //ALE
 /*	if (d_total_pred <= 0.05)
@@ -517,13 +891,20 @@ int Dynamic::SOC_CC(int sp, int st)
 // ALE: ahora  calculo la CC en funcion de la cantidad de recursos disponibles para la especie...
 int Dynamic::SOC_CC(int sp, int st)
 {
- int num_SpeciesPreys, num_SpeciesPredators, TotalInds;
-	int num_Species,prey,pred,i;
+	tSOC_Densities dens;
+
+	if (this->_Species.at(sp).get_NumberPreys() == 0) return(this->SOC_CC(sp,st,NULL));//doesn't need the densities
+	this->calc_SOC_Densities(sp,st,&dens);
+
+	return(this->SOC_CC(sp,st,&dens));
+}
+
+int Dynamic::SOC_CC(int sp, int st, tSOC_Densities *dens)
+{
+ int num_SpeciesPreys, TotalInds;
 	float d_prey=0, d_predOfprey=0, a, cc;
 		
-	num_Species = this->get_NumberSpecies();
 	num_SpeciesPreys = this->_Species.at(sp).get_NumberPreys();	
-	num_SpeciesPredators = this->_Species.at(sp).get_NumberPredators();
 
  if(num_SpeciesPreys == 0) // si se trata de una presa primaria...
  {
@@ -534,12 +915,8 @@ int Dynamic::SOC_CC(int sp, int st)
  }
  else
  {
-			for (i=0;i<num_SpeciesPreys;i++)
-			{
-				prey = this->_Species.at(sp).get_Preys(i);//the id of the prey
-				d_prey += this->_Sites.at(st).get_Density(prey-1);//the density of the prey
-				d_predOfprey += this->get_DensityPredOfPrey(st,prey-1);
-			}
+			d_prey = dens->d_prey;//the density of the preys
+			d_predOfprey = dens->d_predOfprey;
 			
 			if(d_predOfprey == 0) //si las presas no tienen predadores...
 			{
@@ -557,34 +934,23 @@ int Dynamic::SOC_CC(int sp, int st)
 }
 
 float Dynamic::SOC_BP(int sp, int st)
+{
+	tSOC_Densities dens;
+
+	this->calc_SOC_Densities(sp,st,&dens);
+
+	return(this->SOC_BP(sp,st,&dens));
+}
+
+float Dynamic::SOC_BP(int sp, int st, tSOC_Densities *dens)
 {
 	int num_SpeciesPreys, num_SpeciesPredators;
-	int num_Species,prey,pred,i;
-	float d_prey, d_pred, d_predOfprey;
 	float bx,by,Bp;
-	int countAux=0;
 		
-	num_Species = this->get_NumberSpecies();
 	num_SpeciesPreys = this->_Species.at(sp).get_NumberPreys();	
 	num_SpeciesPredators = this->_Species.at(sp).get_NumberPredators();
-	bx=0;	
-	for (i=0;i<num_SpeciesPreys;i++)
-	{
-		prey = this->_Species.at(sp).get_Preys(i);//the id of the prey
-		d_prey = this->_Sites.at(st).get_Density(prey-1);//the density of the prey
-		d_predOfprey = this->get_DensityPredOfPrey(st,prey-1);
-		bx += d_prey*(1.0-d_predOfprey);	
-// 		bx += (1.0-d_prey)*d_predOfprey;	
-	}
-	by =0;
-	for (i=0;i<num_SpeciesPredators;i++)
-	{
-		pred = this->_Species.at(sp).get_Predators(i);//the id of the predator
-		d_pred = this->_Sites.at(st).get_Density(pred-1);//the density of the predator
-		
-// 		by += (1.0 - d_pred);
-		by += d_pred;
-	}
+	bx = dens->bx;
+	by = dens->dy;
 // 	if ((num_SpeciesPreys > 0) || (num_SpeciesPredators >0)) Bp = (float)(bx + by)/(num_SpeciesPreys + num_SpeciesPredators);
  /*Bp=0; countAux=0;
 	if ((num_SpeciesPreys > 0))    {Bp += (float)bx/num_SpeciesPreys; countAux++;}  //ALE
@@ -618,18 +984,47 @@ float Dynamic::SOC_BP(int sp, int st)
 	return(Bp*1.0);//return(Bp*0.5 a 0.6, 0.9);
 }
 
+/*To compute again the rates of 'sp' at 'st' if the site has changed since they were computed. The rates only change
+ * when some abundance (or the reproductive exitus) of the site changes, because all the densities are relative to the
+ * total population of the site. So they are kept in the Abundance matrix and just recalculated when the version of the
+ * site has changed.
+ * */
+void Dynamic::update_Rates(int sp, int st)
+{
+	int i;
+	tSOC_Densities dens;
+
+	i = this->_Abundance.ix(st,sp);
+	if (this->_Abundance.rate_Version[i] != this->_Abundance.site_Version[st])
+	{
+		this->calc_SOC_Densities(sp,st,&dens);
+		this->_Abundance.rate_bp[i] = this->SOC_BP(sp,st,&dens);
+		this->_Abundance.rate_dp[i] = this->SOC_DP(sp,st,&dens);
+		this->_Abundance.rate_mp[i] = this->SOC_MP(sp,st);
+		this->_Abundance.rate_ndp[i] = this->SOC_NDP(sp,st,&dens);
+		this->_Abundance.rate_cc[i] = this->SOC_CC(sp,st,&dens);
+		this->_Abundance.rate_Version[i] = this->_Abundance.site_Version[st];
+	}
+
+	return;
+}
+
+/*The same value of SOC_CC(sp,st), from the rates that were kept if the site didn't change
+ * */
+int Dynamic::get_RateCC(int sp, int st)
+{
+	this->update_Rates(sp,st);
+	return(this->_Abundance.rate_cc[this->_Abundance.ix(st,sp)]);
+}
+
 void Dynamic::SOC(int sp, int st)
 {
-	float dp,bp,ndp,mp;
-	int cc;
+	PROFILE_SCOPE(&this->profiler,PROFILE_SOC);
+	int i;
 	
-	bp = this->SOC_BP(sp,st);
-	dp = this->SOC_DP(sp,st);
-	mp = this->SOC_MP(sp,st);
-	ndp = this->SOC_NDP(sp,st);
-	cc = this->SOC_CC(sp,st);
-//	ndp = this->_Species.at(sp).get_NaturalDeathProbability();
-	this->_Species.at(sp).set_Data(dp,bp,ndp,mp,cc);
+	i = this->_Abundance.ix(st,sp);
+	this->update_Rates(sp,st);//the rates are kept for each site (see update_SpeciesData)
+	this->_Abundance.rate_Step[i] = this->mc_timestep;
 	
 // 	ALE Info
 // cerr << "RAND: " << (float)(random()%PRECISION)/PRECISION << endl;
@@ -641,34 +1036,122 @@ void Dynamic::SOC(int sp, int st)
 	return;	
 }
 
-void Dynamic::print_SOC_SpaceOfParameters(int st, int realization)
+/*The SOC rates of all the species of the site 'st' at once (if they are not up to date), for the engines that need all
+ * of them (TauLeap_Site, Gillespie_Step): the vector of densities of the site is calculated once and the sums of
+ * calc_SOC_Densities are products of the compressed lists of preys and predators by that vector. The rates are the
+ * ones of SOC_BP, SOC_DP, SOC_NDP, SOC_MP and SOC_CC, with the same float operations, calculated in loops over the
+ * species without branches. Each site uses its own slice of soc_Work, so the sites can run at the same time.
+ * */
+void Dynamic::SOC_Site(int st)
 {
-	int sp,cont,nInd;
-	float bp,dp,mp,ndp;
-	ofstream f1;
-	ostringstream os2,os3,os4;
-	vector<string> names_OutputFile;	
-
-	os2 << "SOC_Parameters_sp_00";
-	os3 << "SOC_Parameters_sp_0";
-	os4 << "SOC_Parameters_sp_";
-	for (sp=0;sp<(int)this->_Species.size();sp++)
+	PROFILE_SCOPE(&this->profiler,PROFILE_SOC);
+	int sp,k,i,nSpe,total,num,nPreys,nPred,stale;
+	float *d,*pd,*bx,*dx,*dprey,*dpo,*dy,Dp,Bp,cc;
+	unsigned int version;
+
+	nSpe = (int)this->_Species.size();
+	version = this->_Abundance.site_Version[st];
+	stale = 0;
+	for (sp=0;(sp<nSpe)&&(!stale);sp++) stale = (this->_Abundance.rate_Version[this->_Abundance.ix(st,sp)] != version);
+	if (!stale) return;
+	if (this->soc_Work.size() != 7*this->_Sites.size()*nSpe) this->soc_Work.resize(7*this->_Sites.size()*nSpe);//(only before the parallel loops)
+	d = &this->soc_Work[7*st*nSpe];
+	pd = d + nSpe;//density of the predators of each species (of their nOld, as get_DensityPredOfPrey)
+	bx = pd + nSpe;
+	dx = bx + nSpe;
+	dprey = dx + nSpe;
+	dpo = dprey + nSpe;
+	dy = dpo + nSpe;
+	total = this->_Abundance.total_Population[st];
+	for (sp=0;sp<nSpe;sp++)
 	{
-		ostringstream os1;
-		if(sp<9) os1 << os2.str() << sp+1 << "_seed_" << this->seed << "_real_" << realization <<  ".dat";
-		else if((sp>=9)&&(sp<99)) os1 << os3.str() << sp+1 << "_seed_" << this->seed << "_real_" << realization <<  ".dat";
-		else if((sp>=99)&&(sp<999)) os1 << os4.str() << sp+1 << "_seed_" << this->seed << "_real_" << realization <<  ".dat";
-		names_OutputFile.push_back(os1.str());
-		os1.str().erase();
+		if (total) d[sp] = (float)this->_Abundance.nInd[this->_Abundance.ix(st,sp)]/total;
+		else d[sp] = 0;
 	}
-	for (sp=0;sp<(int)this->_Species.size();sp++)
+	for (sp=0;sp<nSpe;sp++)
 	{
-		f1.open(names_OutputFile.at(sp).c_str(),ofstream::app);
-		if (st != -1)
+		num = 0;
+		dy[sp] = 0.0;
+		for (k=this->predators_Offset[sp];k<this->predators_Offset[sp+1];k++)
 		{
-			bp = this->get_SOC_AvrBirthProb(sp,st);
-			dp = this->get_SOC_AvrDeathProb(sp,st);
-			mp = this->get_SOC_AvrMigProb(sp,st);
+			num += this->_Abundance.nOld[this->_Abundance.ix(st,this->predators_Index[k])];
+			dy[sp] += d[this->predators_Index[k]];
+		}
+		if (total) pd[sp] = (float)num/total;
+		else pd[sp] = 0;
+	}
+	for (sp=0;sp<nSpe;sp++)
+	{
+		bx[sp] = 0.0;
+		dx[sp] = 0.0;
+		dprey[sp] = 0.0;
+		dpo[sp] = 0.0;
+		for (k=this->preys_Offset[sp];k<this->preys_Offset[sp+1];k++)
+		{
+			bx[sp] += d[this->preys_Index[k]]*(1.0-pd[this->preys_Index[k]]);
+			dx[sp] += (pd[this->preys_Index[k]]*(1-d[this->preys_Index[k]]));
+			dprey[sp] += d[this->preys_Index[k]];
+			dpo[sp] += pd[this->preys_Index[k]];
+		}
+	}
+	for (sp=0;sp<nSpe;sp++)
+	{
+		i = this->_Abundance.ix(st,sp);
+		nPreys = this->preys_Offset[sp+1] - this->preys_Offset[sp];
+		nPred = this->predators_Offset[sp+1] - this->predators_Offset[sp];
+		Dp = d[sp]*dx[sp];//SOC_NDP
+		this->_Abundance.rate_ndp[i] = ((nPred == 0) && (d[sp] == 1)) ? 1.0 : Dp;
+		Dp = d[sp];//SOC_DP
+		if (nPred > 0) Dp *= 1.0-dy[sp];
+		Dp = (nPreys > 0) ? Dp*dx[sp] : 1.0;
+		this->_Abundance.rate_dp[i] = Dp;
+		Bp = 1.0-d[sp];//SOC_BP
+		if (nPreys > 0) Bp *= bx[sp];
+		if ((nPred > 0) && (dy[sp] > 0)) Bp *= 1.0-dy[sp];
+		this->_Abundance.rate_bp[i] = Bp;
+		Bp = 1.0-this->_Abundance.reproductive_exitus[i];//SOC_MP
+		this->_Abundance.rate_mp[i] = Bp*0.5;
+		if (nPreys == 0) cc = this->_Sites[st].get_CarryingCapacity()/1.0;//SOC_CC
+		else
+		{
+			Dp = (dpo[sp] == 0) ? 1.0/(float)total : dpo[sp];
+			cc = dprey[sp]/Dp;
+		}
+		this->_Abundance.rate_cc[i] = floor(cc);
+		this->_Abundance.rate_Version[i] = version;
+	}
+
+	return;
+}
+
+string Dynamic::get_SOCName(int sp, int realization)
+{
+	ostringstream os1;
+
+	os1 << "SOC_Parameters_sp_";
+	os1.width(3);//(as the files of OutputSink: at least 3 digits, so there is no limit of species)
+	os1.fill('0');
+	os1 << sp+1;
+	os1 << "_seed_" << this->seed << "_real_" << realization <<  ".dat";
+
+	return(os1.str());
+}
+
+void Dynamic::print_SOC_SpaceOfParameters(int st, int realization)
+{
+	PROFILE_SCOPE(&this->profiler,PROFILE_PRINT);
+	int sp,cont,nInd;
+	float bp,dp,mp,ndp;
+	ofstream f1;
+
+	for (sp=0;sp<(int)this->_Species.size();sp++)
+	{
+		f1.open(this->get_OutputName(this->get_SOCName(sp,realization)).c_str(),ofstream::app);
+		if (st != -1)
+		{
+			bp = this->get_SOC_AvrBirthProb(sp,st);
+			dp = this->get_SOC_AvrDeathProb(sp,st);
+			mp = this->get_SOC_AvrMigProb(sp,st);
 			ndp = this->get_SOC_AvrNatDeathProb(sp,st);
 			nInd = this->_Sites.at(st).get_NumberIndSpecies(sp);
 			cont = this->get_SOC_NumIndChoosed(sp,st);
@@ -735,10 +1218,10 @@ void Dynamic::set_SOC_AvrSpcPar(int sp, int st)
 
 	if (sp != -1)
 	{
-		bp = this->_Species.at(sp).get_BirthProbability();
-		dp = this->_Species.at(sp).get_DeathProbability();
-		mp = this->_Species.at(sp).get_MigrationProbability();
-		ndp = this->_Species.at(sp).get_NaturalDeathProbability();
+		bp = this->_Sites.at(st).get_BirthProbability(sp);
+		dp = this->_Sites.at(st).get_DeathProbability(sp);
+		mp = this->_Sites.at(st).get_MigrationProbability(sp);
+		ndp = this->_Sites.at(st).get_NaturalDeathProbability(sp);
 		this->_Sites.at(st).set_SOC_AvrSpcPar(sp,bp,dp,mp,ndp);
 	}
 	else
@@ -750,21 +1233,44 @@ void Dynamic::set_SOC_AvrSpcPar(int sp, int st)
 
 void Dynamic::MonteCarlo(int realization,int space)
 {
-	float nNewBorn,nOldIni;
-	int sp,st,in;//counters for species, sites, iterations and individuals
-	int sumOld;//total of old individuals - for all the species in the same Site
-	vector<int> auxIndex;
+	int sp,st;//counters for species and sites
 	vector<int> id_spe;
-	int alePrint=0; //ALE
- int aleSP3AT0=0; //ALE debugging
- int CantComidas;
- 
+#ifdef MC_PROFILE
+	AllocStats allocs_Total,allocs_Sites;//to count the allocations of memory of the whole Monte Carlo and of the loop of the sites
+	unsigned long allocs_Events=0;
+#endif
 //ALE 	id_spe.push_back(0); id_spe.push_back(4);  //ALE
 //ALE 	if(space!=0) this->SpaceOfParameters(3, &id_spe, 1, space);//to increase the 'ndp' of species from the vector 'id_spe'
 //	this->print_File();
-	for (this->mc_timestep=0;this->mc_timestep<this->niter;this->mc_timestep++)//for each iteration
+	if (this->engine == ENGINE_MEANFIELD)
+	{
+		this->MeanField(realization,space);
+		return;
+	}
+	this->soc_Work.resize(7*this->_Sites.size()*this->_Species.size());//(SOC_Site)
+	if (this->write_Files)
+	{
+		this->_Flows.init(this->neigh_Source,this->neigh_Index,(int)this->_Species.size());
+		if (!this->_Flows.is_Open(this->seed,realization,space)) this->_Flows.open(this->dir_Output,this->seed,realization,space,this->first_Timestep);//(already open if it was read from a checkpoint)
+	}
+	if (this->engine == ENGINE_TAULEAP)
+	{
+		this->tau_Deaths.assign(this->_Sites.size()*this->_Species.size(),0);
+		this->tau_Births.assign(this->_Sites.size()*this->_Species.size(),0);
+	}
+	if (this->engine == ENGINE_GILLESPIE)
+	{
+		this->gillespie_Queue.init((int)this->_Sites.size());
+		this->gillespie_Rates.assign(3*this->_Sites.size()*this->_Species.size(),0.0);
+		this->gillespie_SiteRate.assign(this->_Sites.size(),0.0);
+	}
+#ifdef MC_PROFILE
+	this->profiler.init();
+#endif
+	for (this->mc_timestep=this->first_Timestep;this->mc_timestep<this->niter;this->mc_timestep++)//for each iteration (after the checkpoint, if there was one)
 	{
-		cerr << "MC_TIMESTEP = " << this->mc_timestep << endl;
+		PROFILE_BEGIN_STEP(&this->profiler);
+		*this->out_Log << "MC_TIMESTEP = " << this->mc_timestep << endl;
 // 		if(this->mc_timestep==21 || this->mc_timestep==22) cerr << "ALE1: (t,#sp3)= \t" << this->mc_timestep << "\t" << this->_Sites.at(0).get_Nold(2)<<"\n";
 		
 		if(this->mc_timestep==0)
@@ -772,92 +1278,195 @@ void Dynamic::MonteCarlo(int realization,int space)
 //			this->CoexistenceNetworks();//the first overlapping network is before any predation of migration, just to control!
 		}
 		if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "***********************************************" << endl;
-		for (st=0;st<(int)this->_Sites.size();st++)//for each site
+#ifdef MC_PROFILE
+		allocs_Sites.take_Snapshot();
+#endif
+		if (this->engine == ENGINE_GILLESPIE) this->Gillespie_Step();//all the sites together, with only one clock
+		else
 		{
-// 		 if((this->mc_timestep==78 || this->mc_timestep==79) && (st==6)) cerr << "ALE1: (t,#sp11)= \t" << this->mc_timestep << "\t" << this->_Sites.at(st).get_Nold(10)<<"\n";
-			sumOld=0;
-			auxIndex.clear();
-// 			cerr << "ALE: st: "<< st << " New= | ";//ALE
-			for (sp=0;sp<(int)this->_Species.size();sp++)//to update nold and sumOld values
+			PROFILE_SCOPE(&this->profiler,PROFILE_SITES);
+#pragma omp parallel for schedule(dynamic)
+			for (st=0;st<(int)this->_Sites.size();st++)//for each site - each one only changes its own row of the Abundance matrix and uses its own random numbers
 			{
+				if (this->engine == ENGINE_TAULEAP) this->TauLeap_Site(st);
+				else this->MonteCarlo_Site(st,realization);
+			}//sites
+		}
+#ifdef MC_PROFILE
+		allocs_Events += allocs_Sites.get_Allocations();
+#endif
+		this->update_SpeciesData();
+		for (st=0;st<(int)this->_Sites.size();st++)//the files are written in the order of the sites
+		{
+// 			this->print_SOC_SpaceOfParameters(st,realization);//print a column for each site, a file for each species!
+// 			if(this->mc_timestep==1000){this->print_SOC_SpaceOfParameters(st,realization);} //ALE
+			if((this->mc_timestep==this->niter-1)&&(this->write_Files)){this->print_SOC_SpaceOfParameters(st,realization);} //ALE
+		}
+// 		if((this->mc_timestep==78 || this->mc_timestep==79) ){cerr << "ALE3 " << " #sp(11)=" << this->_Sites.at(6).get_Nold(10)<< endl;} //ALE
+		
+// 			ALE DEBUGGING
+// 	if(this->mc_timestep==21 || this->mc_timestep==22) cerr << "ALE2.00: (t,#sp3)= \t" << this->mc_timestep << "\t" << this->_Sites.at(0).get_Nold(2)<<"\n";
+// 			ALE DEBUGGING
+		
+//		this->print_Variables(-1);	
+  
+		if((this->mc_timestep!=0)&&(!(this->mc_timestep%this->tm)))//if is time for migration
+		{
+			if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "MIGRATION (" << this->mc_timestep+1 << ") BEGINS HERE!" << endl;
+// 			if(this->mc_timestep==21) cerr << "ALE2.01: (t,#sp3)= \t" << this->mc_timestep << "\t" << this->_Sites.at(0).get_Nold(2)<<"\n";
+// 			if((this->mc_timestep==78 || this->mc_timestep==79) ){cerr << "ALE3.5 " <<" #sp(11)=" << this->_Sites.at(6).get_Nold(10)<< endl;} //ALE
+// 			if((this->mc_timestep==7 || this->mc_timestep==8)){cerr << "ALE4 Antes Mig  "<< " t:" << this->mc_timestep <<" #sp(4).Nnew=" << this->_Sites.at(6).get_Nnew(3)<< endl;} //ALE
+			if (this->engine != ENGINE_GILLESPIE) this->Migration(realization);//(with ENGINE_GILLESPIE the migrations were events of Gillespie_Step)
+// 			if((this->mc_timestep==7 || this->mc_timestep==8)){cerr << "ALE4 Post  Mig  "<< " t:" << this->mc_timestep <<" #sp(4).Nnew=" << this->_Sites.at(6).get_Nnew(3)<< endl;} //ALE
+// 			if(this->mc_timestep==21) cerr << "ALE2.02: (t,#sp3)= \t" << this->mc_timestep << "\t" << this->_Sites.at(0).get_Nold(2)<<"\n";
+		}
+// 		if((this->mc_timestep==78 || this->mc_timestep==79) ){cerr << "ALE4 " <<" #sp(11)=" << this->_Sites.at(6).get_Nold(10)<< endl;} //ALE
+		if(!(this->mc_timestep%this->show_each))
+		{
+// 		 if(this->mc_timestep==21) cerr << "ALE2.1: (t,#sp3)= \t" << this->mc_timestep << "\t" << this->_Sites.at(0).get_Nold(2)<<"\n";
+			this->acummulate_IndividualsSpecies(realization);
+			if (this->write_Files) this->print_File(realization,space);
+// 			if(this->mc_timestep==21) cerr << "ALE2.2: (t,#sp3)= \t" << this->mc_timestep << "\t" << this->_Sites.at(0).get_Nold(2)<<"\n";
+		}
+		if( (this->mc_timestep!=0)&&(!(this->mc_timestep%this->save_each))&&(this->write_Files) )
+		{
+			for (sp=0;sp<(int)this->_Species.size();sp++) this->print_TimeSeriesOfSpecies(realization,space);
+			this->_Flows.end_Block(this->mc_timestep);
+		}
+		if((!(this->mc_timestep%this->tcn))&&((this->mc_timestep!=0))&&(this->write_Files))
+		{
+			this->CoexistenceNetworks(realization,space);
+		}
+// 		this->print_SOC_SpaceOfParameters(-1,realization);//breakline
+// 		if(this->mc_timestep==1000){this->print_SOC_SpaceOfParameters(-1,realization);} //ALE
+		if((this->mc_timestep==this->niter-1)&&(this->write_Files)){this->print_SOC_SpaceOfParameters(-1,realization);} //ALE
+		if( (this->mc_timestep!=0)&&(!(this->mc_timestep%this->save_each))&&(this->write_Files)&&(this->write_Checkpoints) )
+		{
+			this->save_Checkpoint(realization,space);//after all the outputs of the iteration
+		}
+		PROFILE_END_STEP(&this->profiler,this->mc_timestep);
+// 		cerr << "ALE: generé SOC\n";
+// 		if(this->mc_timestep==21 || this->mc_timestep==22) cerr << "ALE3: (t,#sp3)= \t" << this->mc_timestep << "\t" << this->_Sites.at(0).get_Nold(2)<<"\n";
+	}//iterations
+	this->first_Timestep = 0;
+	this->_Output.flush();
+	if (this->write_Files) this->_Flows.close(this->niter-1);
+#ifdef MC_PROFILE
+	this->print_Profile(realization,space);
+	*this->out_Log << "ALLOCATIONS IN THE LOOP OF THE SITES (EVENTS, ALL THE THREADS OF THE PROCESS): " << allocs_Events << " NEW" << endl;
+	allocs_Total.print_Report(*this->out_Log,"MONTE CARLO");
+#endif
+	
+	return;
+}
+
+/*The begining of the iteration in the site 'st', for all the engines: the reproductive exitus of the last iteration,
+ * nOld = nOld + nNew and nOldIni = nOld
+ * */
+void Dynamic::start_SiteStep(int st)
+{
+	float nNewBorn,nOldIni;
+	int sp;
+
+	for (sp=0;sp<(int)this->_Species.size();sp++)//to update nold and sumOld values
+	{
 // to calculate nOld_Ini
-				nNewBorn = this->_Sites.at(st).get_NnewBorn(sp);
+		nNewBorn = this->_Sites.at(st).get_NnewBorn(sp);
 // 				fprintf(stderr, "%4d | " , (int)nNewBorn);//ALE
-				
-				nOldIni = this->_Sites.at(st).get_NoldIni(sp);
+		
+		nOldIni = this->_Sites.at(st).get_NoldIni(sp);
 // 				fprintf(stderr, "(%3d/%3d):%3d | " , (int)nOldIni, (int)this->_Species.at(sp).get_CC(),(int)nNewBorn);//ALE
 // to calculate exito_Reprodutivo = nNew_born/nOldIni
-				if(nOldIni)
-					this->_Sites.at(st).set_ReproductiveExitus(sp,(float)nNewBorn/nOldIni);
-				else
-					this->_Sites.at(st).set_ReproductiveExitus(sp,1);
+		if(nOldIni)
+			this->_Sites.at(st).set_ReproductiveExitus(sp,(float)nNewBorn/nOldIni);
+		else
+			this->_Sites.at(st).set_ReproductiveExitus(sp,1);
 // to make nOld = nOld + nNew
-				this->_Sites.at(st).set_Nold(sp,this->_Sites.at(st).get_Nold(sp) + this->_Sites.at(st).get_Nnew(sp));
+		this->_Sites.at(st).set_Nold(sp,this->_Sites.at(st).get_Nold(sp) + this->_Sites.at(st).get_Nnew(sp));
 // to make nOldIni = nOld
-				this->_Sites.at(st).set_NoldIni(sp,this->_Sites.at(st).get_Nold(sp));//the number of individuals at the begining of the iteration
+		this->_Sites.at(st).set_NoldIni(sp,this->_Sites.at(st).get_Nold(sp));//the number of individuals at the begining of the iteration
 // to make nNew = 0 
-				this->_Sites.at(st).set_Nnew(sp, 0);
+		this->_Sites.at(st).set_Nnew(sp, 0);
 // to make nNew_born = 0
-				this->_Sites.at(st).set_NnewBorn(sp,0);
-			}
+		this->_Sites.at(st).set_NnewBorn(sp,0);
+	}
+
+	return;
+}
+
+/*One iteration of the Monte Carlo in the site 'st': the events of the individuals of the site. It only
+ * changes the row 'st' of the Abundance matrix and uses the random numbers of the site, so it can run
+ * at the same time for different sites.
+ * */
+void Dynamic::MonteCarlo_Site(int st, int realization)
+{
+	int sp,in;//counters for species and individuals
+	int sumOld;//total of old individuals - for all the species in the same Site
+	int alePrint=0; //ALE
+ int CantComidas;
+
+// 		 if((this->mc_timestep==78 || this->mc_timestep==79) && (st==6)) cerr << "ALE1: (t,#sp11)= \t" << this->mc_timestep << "\t" << this->_Sites.at(st).get_Nold(10)<<"\n";
+		sumOld=0;
+// 			cerr << "ALE: st: "<< st << " New= | ";//ALE
+		this->start_SiteStep(st);//nOld = nOld + nNew...
 // 			cerr << "-ALE"<< endl; //ALE
-			sumOld=this->_Sites.at(st).calculate_SumOld();
+		sumOld=this->_Sites.at(st).get_SumOld();
 // 			cerr << "					ALE - @st: " << st << " sumOld= " << sumOld << endl;
-			in=0;
-			if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "***********************************************" << endl;
+		in=0;
+		if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "***********************************************" << endl;
 // 			if(this->mc_timestep==30 && st==43){cerr << "#sp(11)=" << this->_Sites.at(st).get_NumberIndSpecies(2)<< endl;} //ALE
-			
-			
+		
+		
 // 			while(in < sumOld)
 // 			while(in < 0.2*sumOld) //ALE: para acelerar el tiempo...
 //    cerr << "ALE: sumOld= "<< sumOld << " log(sumOld): " << log(sumOld)<< endl;
 // 			while(in < 30.0*log(sumOld)) //ALE: para acelerar el tiempo...
-			while(in < 10.0*log(sumOld)) //ALE: para acelerar el tiempo...
-			{
+		while(in < 10.0*log(sumOld)) //ALE: para acelerar el tiempo...
+		{
 /*			 //ALE debugging
-			 aleSP3AT0=this->_Sites.at(0).get_Nold(2);
-			 cerr << in << " " << aleSP3AT0 << endl;
-			 if (aleSP3AT0<0) {
-			 	cerr << "aleSP3AT0 < 0\n";
-			 	exit(1);
-			 }
-			 //ALE debugging*/
+		 aleSP3AT0=this->_Sites.at(0).get_Nold(2);
+		 cerr << in << " " << aleSP3AT0 << endl;
+		 if (aleSP3AT0<0) {
+		 	cerr << "aleSP3AT0 < 0\n";
+		 	exit(1);
+		 }
+		 //ALE debugging*/
 // 				if((this->mc_timestep==21 || this->mc_timestep==22) && st==0){cerr << "ALE (in="<< in <<" #sp(3)=" << this->_Sites.at(st).get_Nold(2)<< endl;} //ALE
 // 				if((this->mc_timestep==78 || this->mc_timestep==79) && st==6){cerr << "ALE2 (in="<< in <<" #sp(11)=" << this->_Sites.at(st).get_Nold(10)<< endl;} //ALE
-				
-				if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "***** IT = " << this->mc_timestep+1 << " ******* SITE = " << st+1 << "***IND = " << in+1 << " ***** UNTIL " << sumOld << "*****" << endl;
-				this->print_Variables(st);	
+			
+			if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "***** IT = " << this->mc_timestep+1 << " ******* SITE = " << st+1 << "***IND = " << in+1 << " ***** UNTIL " << sumOld << "*****" << endl;
+			this->print_Variables(st);	
 // 				sp = this->_Sites.at(st).get_RandomSpecies(realization,sumOld,this->_Sites.at(st).aux_ListSpecies);//random choice of a species among all of them
-				sp = this->_Sites.at(st).get_RandSP();  //ALE 
+			sp = this->_Sites.at(st).get_RandSP();  //ALE 
 // 				cerr << "ALE - sp: "<< sp << endl;
 // 				if ( (st==0) && (this->mc_timestep==87) && (in==75)) cerr << "sp selected: " << sp+1 << endl; //ALE
-				this->set_SOC_AvrSpcPar(-1,st);//to start the accummulator!!
-				if (sp != -1)//if sp=-1 means that there are no individuals in the list of species given to the method
-				{
-					//ALE
+			this->set_SOC_AvrSpcPar(-1,st);//to start the accummulator!!
+			if (sp != -1)//if sp=-1 means that there are no individuals in the list of species given to the method
+			{
+				PROFILE_COUNT(&this->profiler,PROFILE_EVENTS,1);
+				//ALE
 // 					if( (st==43) && (this->mc_timestep==30) && (sp==10 || sp==2 || sp==8 )) alePrint=1; else alePrint=0;  //ALE
 // 					if( ((st==0) && (this->mc_timestep==87) && (sp==2 || in==75)) || this->mc_timestep==88) alePrint=1; else alePrint=0;  //ALE
 // 					if( ((st==0) && (this->mc_timestep==21 || this->mc_timestep==22) ) ) alePrint=1; else alePrint=0;  //ALE
 // 								if((this->mc_timestep==7 || this->mc_timestep==8) && st==6 && sp>=0){cerr << "ALE3  in: "<< in << "/" << sumOld << " t:" << this->mc_timestep <<" spSelected:" << sp <<" #sp(4).Nnew=" << this->_Sites.at(st).get_Nnew(3)<< endl;} //ALE
-				//ALE
+			//ALE
 //      if(alePrint){ cerr << "ALE: sp "<< sp+1 << "@st: "<<st<< "["<< this->_Sites.at(st).get_NumberIndSpecies(sp) << "]"<<endl; }  //ALE
-					this->SOC(sp,st);//Self Organizing Criticality - to change the parameters depending on the densities (ROZENFELD & ALBANO 2004)
-					if (this->_Species.at(sp).ver_NaturalDeath(this->mc_timestep,(float)(random()%PRECISION)/PRECISION) )//verify if the species dies naturally
-					{
-						if(alePrint){ cerr << "<NatDeath> "<<endl;} //ALE
-						this->_Sites.at(st).to_Die(sp);
-// 						this->_Sites.at(st).aux_ListSpecies.at(sp)--; //ALE;
-						this->_Sites.at(st).MCdata.at(sp)--;
+				this->SOC(sp,st);//Self Organizing Criticality - to change the parameters depending on the densities (ROZENFELD & ALBANO 2004)
+				if (this->_Sites.at(st).ver_NaturalDeath(sp,this->_Sites.at(st).get_RandomProbability()) )//verify if the species dies naturally
+				{
+					if(alePrint){ cerr << "<NatDeath> "<<endl;} //ALE
+					this->_Sites.at(st).to_Die(sp);
+					PROFILE_COUNT(&this->profiler,PROFILE_DEATHS,1);
 // 						in++; //ALE  hay que hacer una iteracion menos, debido a que hay un individuo menos...
-					}	
-					else//if doesnt die naturally
-					{
-					 if(alePrint){ 
-					 	cerr << "<DynamicPrey> "<<endl; 
-					 	this->DynamicPrey(st, sp, -1);   //realization=-1 para imprimir dentro de DynamicPrey
-					 }  //ALE
-					 else
-					 {
+				}	
+				else//if doesnt die naturally
+				{
+				 if(alePrint){ 
+				 	cerr << "<DynamicPrey> "<<endl; 
+				 	this->DynamicPrey(st, sp, -1);   //realization=-1 para imprimir dentro de DynamicPrey
+				 }  //ALE
+				 else
+				 {
 // 					 	for(int comidas=1; comidas<=this->get_NumberIndPreys(int st,int sp); comidas++) //trato de comerlas todas...
 // 								for(int comidas=1; comidas<=5; comidas++)
 // 								int num_SpeciesPreys = this->_Species.at(sp).get_NumberPreys();	
@@ -869,128 +1478,671 @@ void Dynamic::MonteCarlo(int realization,int space)
 // 								CantComidas=50;
 // 								CantComidas=this->_Species.at(sp).get_NumberPreys();	
 
-								int cantPreys=this->get_NumberIndPreys(st,sp);
-								if(cantPreys) CantComidas=floor(log(cantPreys))+1;
-								else CantComidas=5;
+							int cantPreys=this->get_NumberIndPreys(st,sp);
+							if(cantPreys) CantComidas=floor(log(cantPreys))+1;
+							else CantComidas=5;
 // 								CantComidas=5;
-								
+							
 // 								cerr << "ALE - sp:"<< sp <<" CantComidas: " << CantComidas << endl;
-								for(int comidas=1; comidas<=CantComidas; comidas++) //trato de comerlas todas...
-						 		this->DynamicPrey(st, sp, realization);
-						}
-					//ALE
-// 					this->DynamicPrey(st, sp, realization);
+							for(int comidas=1; comidas<=CantComidas; comidas++) //trato de comerlas todas...
+					 		this->DynamicPrey(st, sp, realization);
 					}
-					sumOld = this->_Sites.at(st).calculate_SumOld(); //ALE
-					this->set_SOC_AvrSpcPar(sp,st);
-				}// if has at least one individual in the list of species
-				in++;
-			}//counter of individuals 
+				//ALE
+// 					this->DynamicPrey(st, sp, realization);
+				}
+				sumOld = this->_Sites.at(st).get_SumOld(); //ALE
+				this->set_SOC_AvrSpcPar(sp,st);
+			}// if has at least one individual in the list of species
+			in++;
+		}//counter of individuals 
 
-// 			this->print_SOC_SpaceOfParameters(st,realization);//print a column for each site, a file for each species!
-// 			if(this->mc_timestep==1000){this->print_SOC_SpaceOfParameters(st,realization);} //ALE
-			if(this->mc_timestep==this->niter-1){this->print_SOC_SpaceOfParameters(st,realization);} //ALE
-			
-/*			for(int sp_aux=0; sp_aux< this->_Species.size(); sp_aux++)  //ALE
-				cerr << "ALE - repExitus VS bp: " << this->_Sites.at(st).get_ReproductiveExitus(sp_aux) << " " << this->_Species.at(sp_aux).get_BirthProbability() << endl; //ALE
-			cerr << "ALE - repExitus VS bp: " << endl; //ALE*/
-			
-//    if(this->mc_timestep==30 && st==43){cerr << "#sp(11)=" << this->_Sites.at(st).get_NumberIndSpecies(2)<< endl;} //ALE
-		}//sites
-// 		if((this->mc_timestep==78 || this->mc_timestep==79) ){cerr << "ALE3 " << " #sp(11)=" << this->_Sites.at(6).get_Nold(10)<< endl;} //ALE
 		
-// 			ALE DEBUGGING
-// 	if(this->mc_timestep==21 || this->mc_timestep==22) cerr << "ALE2.00: (t,#sp3)= \t" << this->mc_timestep << "\t" << this->_Sites.at(0).get_Nold(2)<<"\n";
-// 			ALE DEBUGGING
+/*			for(int sp_aux=0; sp_aux< this->_Species.size(); sp_aux++)  //ALE
+			cerr << "ALE - repExitus VS bp: " << this->_Sites.at(st).get_ReproductiveExitus(sp_aux) << " " << this->_Species.at(sp_aux).get_BirthProbability() << endl; //ALE
+		cerr << "ALE - repExitus VS bp: " << endl; //ALE*/
 		
-//		this->print_Variables(-1);	
-  
-		if((this->mc_timestep!=0)&&(!(this->mc_timestep%this->tm)))//if is time for migration
+//    if(this->mc_timestep==30 && st==43){cerr << "#sp(11)=" << this->_Sites.at(st).get_NumberIndSpecies(2)<< endl;} //ALE
+	return;
+}
+
+/*One iteration of the site 'st' with tau-leaping (ENGINE_TAULEAP): the rates of the species are the ones of the
+ * begining of the iteration (SOC) and the events of the iteration are sampled in bulk, instead of one by one:
+ * - the 10*log(sumOld) choices of a species of MonteCarlo_Site are shared among the species alive (multinomial)
+ * - the natural deaths of a species are Binomial(choices, ndp)
+ * - the survivors try to eat as many times as in MonteCarlo_Site: the attempts are shared among the preys by their nOld,
+ *   the preys die with their dp and each prey that dies gives a birth of the predator with its bp
+ * - the species without preys are born with their bp
+ * The births are never more than the carrying capacity of the species allows and the deaths never more than nOld. All of
+ * them are applied at the end of the iteration, so the rates and the preys don't change during the iteration.
+ * */
+void Dynamic::TauLeap_Site(int st)
+{
+	int sp,q,k,i,nSpe,left,choices,n,d,attempts,a,rem,w,kills,room,preyInd,cantComidas,sumOld;
+	Site *site;
+	Random *rng;
+
+	this->start_SiteStep(st);
+	this->SOC_Site(st);//the rates of the begining of the iteration
+	site = &this->_Sites[st];
+	rng = site->get_Random();
+	nSpe = (int)this->_Species.size();
+	sumOld = site->get_SumOld();
+	choices = (sumOld > 0) ? (int)ceil(10.0*log(sumOld)) : 0;
+	PROFILE_COUNT(&this->profiler,PROFILE_EVENTS,choices);
+	left = this->_Abundance.get_NumberPresentSpecies(st);
+	for (sp=0;(sp<nSpe)&&(left>0);sp++)
+	{
+		if (site->get_Nold(sp) <= 0) continue;
+		n = rng->get_Binomial(choices,1.0/left);//choices of this species
+		choices -= n;
+		left--;
+		if (n == 0) continue;
+		this->SOC(sp,st);
+		this->set_SOC_AvrSpcPar(sp,st);
+		d = rng->get_Binomial(n,site->get_NaturalDeathProbability(sp));
+		this->tau_Deaths[this->_Abundance.ix(st,sp)] += d;
+		PROFILE_COUNT(&this->profiler,PROFILE_DEATHS,d);
+		preyInd = this->get_NumberIndPreys(st,sp);
+		if (preyInd) cantComidas = (int)floor(log(preyInd)) + 1;
+		else cantComidas = 5;
+		attempts = (n - d)*cantComidas;
+		if (this->_Species.at(sp).ver_IsPredator())
+		{
+			kills = 0;
+			rem = preyInd;
+			for (k=this->preys_Offset[sp];(k<this->preys_Offset[sp+1])&&(attempts>0)&&(rem>0);k++)
+			{
+				q = this->preys_Index[k];
+				w = site->get_Nold(q);
+				if (w <= 0) continue;
+				a = rng->get_Binomial(attempts,(double)w/rem);//attempts on this prey
+				attempts -= a;
+				rem -= w;
+				if (a == 0) continue;
+				this->SOC(q,st);
+				d = rng->get_Binomial(a,site->get_DeathProbability(q));
+				this->tau_Deaths[this->_Abundance.ix(st,q)] += d;
+				PROFILE_COUNT(&this->profiler,PROFILE_PREDATIONS,d);
+				kills += d;
+			}
+			attempts = kills;//each prey that dies can give a birth
+		}
+		room = site->get_SpeciesCC(sp) - site->get_NumberIndSpecies(sp);
+		if (room > 0) this->tau_Births[this->_Abundance.ix(st,sp)] = min(rng->get_Binomial(attempts,site->get_BirthProbability(sp)),room);
+	}
+	for (sp=0;sp<nSpe;sp++)
+	{
+		i = this->_Abundance.ix(st,sp);
+		if (this->tau_Deaths[i]) site->set_Nold(sp,max(site->get_Nold(sp) - this->tau_Deaths[i],0));
+		if (this->tau_Births[i]) site->to_Born(sp,this->tau_Births[i]);
+		PROFILE_COUNT(&this->profiler,PROFILE_BIRTHS,this->tau_Births[i]);
+		this->tau_Deaths[i] = 0;
+		this->tau_Births[i] = 0;
+	}
+
+	return;
+}
+
+/*One iteration (one unit of time) of all the sites with the next-reaction method of Gibson & Bruck (ENGINE_GILLESPIE).
+ * The events of the site 'st' are the ones of MonteCarlo_Site in continuous time, with the rates (per unit of time) of
+ * each species 'sp' alive:
+ * - natural death - c*ndp, where c = 10*log(sumOld)/(species alive) are the choices of 'sp' in one iteration of MonteCarlo_Site
+ * - feeding       - c*(1-ndp)*cantComidas*(sum over the preys of nOld_prey*dp_prey)/(individuals of the preys): a prey
+ *                   (chosen by nOld_prey*dp_prey) dies and the predator is born with bp, if it is below its cc.
+ *                   The species without preys are born with the rate c*(1-ndp)*cantComidas*bp, if they are below their cc.
+ * - migration     - mp*nOld/tm: one individual goes to a neighbor chosen by (Pref_neighbor - Pref_site)*weight, as in
+ *                   Migration, if it is below its cc there (if no neighbor is preferred nothing happens)
+ * The queue keeps the time of the next event of each site. As all the rates of a site depend on the densities of the
+ * site, an event only changes the rates of its site (and of the target of a migration), so only these sites are
+ * updated: the site of the event gets a new time and the target keeps its time, rescaled by its old/new rates.
+ * At the begining of each iteration all the sites start their step (start_SiteStep) and get new times, so the
+ * births of an iteration are nNew until the next one, as in MonteCarlo_Site. It uses the stream of the Dynamic for
+ * the times and the stream of each site for its events.
+ * */
+void Dynamic::Gillespie_Step(void)
+{
+	PROFILE_SCOPE(&this->profiler,PROFILE_SITES);
+	int st,tg,nSites;
+	double now,end,oldRate,newRate,oldTime;
+
+	nSites = (int)this->_Sites.size();
+	now = this->mc_timestep;
+	end = now + 1.0;
+	for (st=0;st<nSites;st++)
+	{
+		this->start_SiteStep(st);
+		this->gillespie_Queue.set_Time(st,now + this->rng.get_Exponential(this->calc_GillespieRates(st)));
+	}
+	while (this->gillespie_Queue.get_TopTime() < end)
+	{
+		st = this->gillespie_Queue.get_Top();
+		now = this->gillespie_Queue.get_TopTime();
+		tg = this->Gillespie_Event(st);
+		this->gillespie_Queue.set_Time(st,now + this->rng.get_Exponential(this->calc_GillespieRates(st)));
+		if ((tg >= 0) && (tg != st))//the target of a migration
+		{
+			oldRate = this->gillespie_SiteRate[tg];
+			oldTime = this->gillespie_Queue.get_Time(tg);
+			newRate = this->calc_GillespieRates(tg);
+			if (newRate <= 0) this->gillespie_Queue.set_Time(tg,HUGE_VAL);
+			else if ((oldRate <= 0) || (oldTime == HUGE_VAL)) this->gillespie_Queue.set_Time(tg,now + this->rng.get_Exponential(newRate));
+			else this->gillespie_Queue.set_Time(tg,now + (oldRate/newRate)*(oldTime - now));
+		}
+	}
+
+	return;
+}
+
+/*The rates of the events of the species of the site 'st' (see Gillespie_Step). Returns their sum
+ * */
+double Dynamic::calc_GillespieRates(int st)
+{
+	int sp,k,q,n,w,nSpe,present,sumOld,preyInd,cantComidas;
+	double c,ndp,eat,total,*r;
+	Site *site;
+
+	this->SOC_Site(st);
+	site = &this->_Sites[st];
+	nSpe = (int)this->_Species.size();
+	present = this->_Abundance.get_NumberPresentSpecies(st);
+	sumOld = site->get_SumOld();
+	c = ((present > 0) && (sumOld > 0)) ? 10.0*log(sumOld)/present : 0.0;
+	total = 0.0;
+	for (sp=0;sp<nSpe;sp++)
+	{
+		r = &this->gillespie_Rates[3*this->_Abundance.ix(st,sp)];
+		r[0] = 0.0;
+		r[1] = 0.0;
+		r[2] = 0.0;
+		n = site->get_Nold(sp);
+		if (n <= 0) continue;
+		this->SOC(sp,st);
+		ndp = site->get_NaturalDeathProbability(sp);
+		preyInd = this->_Abundance.get_NumberIndPreys(st,sp);
+		if (preyInd) cantComidas = (int)floor(log(preyInd)) + 1;
+		else cantComidas = 5;
+		r[0] = c*ndp;
+		if (this->_Species.at(sp).ver_IsPredator())
+		{
+			eat = 0.0;
+			for (k=this->preys_Offset[sp];k<this->preys_Offset[sp+1];k++)
+			{
+				q = this->preys_Index[k];
+				w = site->get_Nold(q);
+				if (w <= 0) continue;
+				this->SOC(q,st);
+				eat += w*site->get_DeathProbability(q);
+			}
+			if (preyInd) r[1] = c*(1.0 - ndp)*cantComidas*eat/preyInd;
+		}
+		else if (site->get_NumberIndSpecies(sp) < site->get_SpeciesCC(sp)) r[1] = c*(1.0 - ndp)*cantComidas*site->get_BirthProbability(sp);
+		if (this->neigh_Offset[st+1] > this->neigh_Offset[st]) r[2] = (double)this->_Species.at(sp).get_MigrationProbability()*n/this->tm;
+		total += r[0] + r[1] + r[2];
+	}
+	this->gillespie_SiteRate[st] = total;
+
+	return(total);
+}
+
+/*One event of the site 'st', chosen by the rates of calc_GillespieRates. Returns the target site of a migration
+ * (-1 if the event was not a migration)
+ * */
+int Dynamic::Gillespie_Event(int st)
+{
+	int i,k,e,sp,ev,q,nSpe,pref,tg;
+	double u,sum,dif;
+	Site *site;
+	Random *rng;
+
+	site = &this->_Sites[st];
+	rng = site->get_Random();
+	nSpe = (int)this->_Species.size();
+	u = rng->get_UniformDouble()*this->gillespie_SiteRate[st];
+	sp = -1;
+	ev = -1;
+	for (i=0;(i<3*nSpe)&&(ev<0);i++)
+	{
+		k = 3*this->_Abundance.ix(st,i/3) + i%3;
+		if (this->gillespie_Rates[k] <= 0) continue;
+		sp = i/3;
+		if (u < this->gillespie_Rates[k]) ev = i%3;
+		else u -= this->gillespie_Rates[k];
+	}
+	if (sp < 0) return(-1);
+	if (ev < 0)//rounding: the last event with rate
+	{
+		for (ev=2;this->gillespie_Rates[3*this->_Abundance.ix(st,sp)+ev]<=0;ev--);
+	}
+	this->set_SOC_AvrSpcPar(sp,st);
+	PROFILE_COUNT(&this->profiler,PROFILE_EVENTS,1);
+	if (ev == 0)//natural death
+	{
+		site->to_Die(sp);
+		PROFILE_COUNT(&this->profiler,PROFILE_DEATHS,1);
+	}
+	else if (ev == 1)//feeding
+	{
+		if (this->_Species.at(sp).ver_IsPredator())
+		{
+			sum = 0.0;
+			for (k=this->preys_Offset[sp];k<this->preys_Offset[sp+1];k++) sum += site->get_Nold(this->preys_Index[k])*site->get_DeathProbability(this->preys_Index[k]);
+			u = rng->get_UniformDouble()*sum;
+			q = -1;
+			for (k=this->preys_Offset[sp];(k<this->preys_Offset[sp+1])&&(u>=0);k++)
+			{
+				if (site->get_Nold(this->preys_Index[k]) <= 0) continue;
+				q = this->preys_Index[k];
+				u -= site->get_Nold(q)*site->get_DeathProbability(q);
+			}
+			if (q < 0) return(-1);
+			site->to_Die(q);
+			PROFILE_COUNT(&this->profiler,PROFILE_PREDATIONS,1);
+			if ((site->ver_Birth(sp,site->get_RandomProbability())) && (site->get_SpeciesCC(sp) > site->get_NumberIndSpecies(sp)))
+			{
+				site->to_Born(sp);
+				PROFILE_COUNT(&this->profiler,PROFILE_BIRTHS,1);
+			}
+		}
+		else
+		{
+			site->to_Born(sp);
+			PROFILE_COUNT(&this->profiler,PROFILE_BIRTHS,1);
+		}
+	}
+	else//migration
+	{
+		pref = this->_Abundance.get_NumberIndPreys(st,sp) - this->get_NumberIndPredators(st,sp);
+		sum = 0.0;
+		for (k=this->neigh_Offset[st];k<this->neigh_Offset[st+1];k++)
+		{
+			q = this->neigh_Index[k];
+			dif = (this->_Abundance.get_NumberIndPreys(q,sp) - this->get_NumberIndPredators(q,sp) - pref)*this->neigh_Weight[k];
+			if (dif > 0) sum += dif;
+		}
+		if (sum <= 0) return(-1);//no neighbor is preferred
+		u = rng->get_UniformDouble()*sum;
+		tg = -1;
+		e = -1;
+		for (k=this->neigh_Offset[st];(k<this->neigh_Offset[st+1])&&(u>=0);k++)
+		{
+			q = this->neigh_Index[k];
+			dif = (this->_Abundance.get_NumberIndPreys(q,sp) - this->get_NumberIndPredators(q,sp) - pref)*this->neigh_Weight[k];
+			if (dif <= 0) continue;
+			tg = q;
+			e = k;
+			u -= dif;
+		}
+		if (this->_Sites[tg].get_NumberIndSpecies(sp) >= this->SOC_CC(sp,tg)) return(-1);//the target is full
+		site->set_Nold(sp,site->get_Nold(sp) - 1);
+		this->_Sites[tg].set_Nnew(sp,this->_Sites[tg].get_Nnew(sp) + 1);
+		this->_Flows.add_Flow(e,sp,1);
+		PROFILE_COUNT(&this->profiler,PROFILE_MIGRATIONS,1);
+		return(tg);
+	}
+
+	return(-1);
+}
+
+/*The summary of the Profiler in the log and the times and events of each iteration in
+ * profile_seed_S_real_R_changes_C.csv (only with MC_PROFILE)
+ * */
+void Dynamic::print_Profile(int realization, int changes)
+{
+	ostringstream os1;
+
+	this->profiler.print_Summary(*this->out_Log);
+	if (!this->write_Files) return;
+	os1 << "profile_seed_" << this->seed << "_real_" << realization << "_changes_" << changes << ".csv";
+	if (!this->profiler.write_Steps(this->get_OutputName(os1.str()))) *this->out_Log << "IT WAS NOT POSSIBLE TO WRITE " << os1.str() << endl;
+
+	return;
+}
+
+/*The deterministic mean field of the rates of Gillespie_Step (ENGINE_MEANFIELD): the individuals of each site and
+ * species are real numbers, integrated with the Runge-Kutta of Dormand & Prince (5th order, with adaptive steps). At
+ * the end of each iteration (one unit of time) they are rounded into the Abundance matrix, so the outputs are the ones
+ * of MonteCarlo (print_File, the time series and the coexistence networks), without the SOC files and the checkpoints.
+ * */
+void Dynamic::MeanField(int realization, int changes)
+{
+	int i,sp,st,n,nSit,nSpe,steps;
+	double h;
+
+	nSit = (int)this->_Sites.size();
+	nSpe = (int)this->_Species.size();
+	n = nSit*nSpe;
+	this->meanField_X.resize(n);
+	this->meanField_K.assign(8*n,0.0);
+	this->meanField_Work.assign(2*nSit + 13*n,0.0);
+	for (st=0;st<nSit;st++) this->meanField_Work[st] = this->_Sites[st].get_CarryingCapacity();
+	for (i=0;i<n;i++) this->meanField_X[i] = this->_Abundance.nInd[i];
+	h = 0.1;
+	steps = 0;
+#ifdef MC_PROFILE
+	this->profiler.init();
+#endif
+	for (this->mc_timestep=this->first_Timestep;this->mc_timestep<this->niter;this->mc_timestep++)
+	{
+		PROFILE_BEGIN_STEP(&this->profiler);
+		*this->out_Log << "MC_TIMESTEP = " << this->mc_timestep << endl;
+		steps += this->integrate_MeanField(&h);
+		for (sp=0;sp<nSpe;sp++)
+		{
+			for (st=0;st<nSit;st++)
+			{
+				this->_Sites[st].set_Nnew(sp,0);
+				this->_Sites[st].set_Nold(sp,(int)floor(this->meanField_X[this->_Abundance.ix(st,sp)] + 0.5));
+			}
+		}
+		if(!(this->mc_timestep%this->show_each))
+		{
+			this->acummulate_IndividualsSpecies(realization);
+			if (this->write_Files) this->print_File(realization,changes);
+		}
+		if( (this->mc_timestep!=0)&&(!(this->mc_timestep%this->save_each))&&(this->write_Files) )
+		{
+			this->print_TimeSeriesOfSpecies(realization,changes);
+		}
+		if((!(this->mc_timestep%this->tcn))&&((this->mc_timestep!=0))&&(this->write_Files))
+		{
+			this->CoexistenceNetworks(realization,changes);
+		}
+		PROFILE_END_STEP(&this->profiler,this->mc_timestep);
+	}
+	this->first_Timestep = 0;
+	this->_Output.flush();
+	*this->out_Log << "MEAN FIELD: " << steps << " STEPS OF RUNGE-KUTTA" << endl;
+#ifdef MC_PROFILE
+	this->print_Profile(realization,changes);
+#endif
+
+	return;
+}
+
+/*To integrate meanField_X during one unit of time, starting with the step 'h' (that is changed to the next step).
+ * Returns the number of steps
+ * */
+int Dynamic::integrate_MeanField(double *h)
+{
+	//Dormand & Prince (1980): the 7 stages (the last one is the 5th order solution) and the error (5th - 4th order)
+	static const double a[7][6] = {{0,0,0,0,0,0},
+		{1.0/5,0,0,0,0,0},
+		{3.0/40,9.0/40,0,0,0,0},
+		{44.0/45,-56.0/15,32.0/9,0,0,0},
+		{19372.0/6561,-25360.0/2187,64448.0/6561,-212.0/729,0,0},
+		{9017.0/3168,-355.0/33,46732.0/5247,49.0/176,-5103.0/18656,0},
+		{35.0/384,0,500.0/1113,125.0/192,-2187.0/6784,11.0/84}};
+	static const double e[7] = {71.0/57600,0,-71.0/16695,71.0/1920,-17253.0/339200,22.0/525,-1.0/40};
+	int i,j,s,n,steps;
+	double t,hh,err,sc,v,factor;
+	double *x,*k,*y;
+
+	n = (int)this->meanField_X.size();
+	x = &this->meanField_X[0];
+	k = &this->meanField_K[0];
+	y = k + 7*n;
+	t = 0.0;
+	steps = 0;
+	while (t < 1.0)
+	{
+		hh = min(*h,1.0 - t);
+		this->calc_MeanFieldRHS(x,k);
+		for (s=1;s<7;s++)
+		{
+#pragma omp simd private(v,j)
+			for (i=0;i<n;i++)
+			{
+				v = x[i];
+				for (j=0;j<s;j++) v += hh*a[s][j]*k[j*n+i];
+				y[i] = v;
+			}
+			this->calc_MeanFieldRHS(y,k + s*n);
+		}
+		err = 0.0;
+		for (i=0;i<n;i++)
+		{
+			v = 0.0;
+			for (j=0;j<7;j++) v += e[j]*k[j*n+i];
+			sc = MEANFIELD_ATOL + MEANFIELD_RTOL*max(fabs(x[i]),fabs(y[i]));
+			err = max(err,fabs(hh*v)/sc);
+		}
+		if ((err <= 1.0) || (hh <= MEANFIELD_HMIN))//accepted (y is the 5th order solution)
+		{
+			for (i=0;i<n;i++) x[i] = max(y[i],0.0);
+			t += hh;
+			steps++;
+		}
+		factor = (err > 0) ? 0.9*pow(err,-0.2) : 5.0;
+		*h = max(MEANFIELD_HMIN,hh*min(5.0,max(0.2,factor)));
+	}
+
+	return(steps);
+}
+
+/*The derivatives of the individuals 'x' of each site and species (as the Abundance matrix, x[sp*nSites+st]): the
+ * expected changes per unit of time of the events of Gillespie_Step, with the SOC rates of the densities of 'x'. The
+ * conditions of the events (alive, below the cc) are ramps of one individual instead of steps, so the Runge-Kutta
+ * doesn't need tiny steps around them. All the loops over the sites are over contiguous values, to be vectorized.
+ * */
+void Dynamic::calc_MeanFieldRHS(const double *x, double *dxdt)
+{
+	int sp,st,k,p,q,nSit,nSpe,n,nPreys,nPred,tg;
+	double *ccSite,*c,*T,*d,*predDens,*preyInd,*predInd,*bx,*dx,*dprey,*dpredOfprey,*ndp,*dp,*bp,*cc,*A,*eaten;
+	double v,sum,dif,mp;
+	const double *xs;
+
+	nSit = (int)this->_Sites.size();
+	nSpe = (int)this->_Species.size();
+	n = nSit*nSpe;
+	ccSite = &this->meanField_Work[0];
+	c = ccSite + nSit;
+	T = c + nSit;
+	d = T + n; predDens = d + n; preyInd = predDens + n; predInd = preyInd + n;
+	bx = predInd + n; dx = bx + n; dprey = dx + n; dpredOfprey = dprey + n;
+	ndp = dpredOfprey + n; dp = ndp + n; bp = dp + n;
+	cc = bx;//(bx is not used after the rates)
+	A = dx;
+	eaten = dprey;
+	for (st=0;st<nSit;st++)
+	{
+		T[st] = 0.0;
+		c[st] = 0.0;
+	}
+	for (sp=0;sp<nSpe;sp++)//the individuals and the species alive of each site
+	{
+		xs = x + sp*nSit;
+#pragma omp simd
+		for (st=0;st<nSit;st++)
+		{
+			T[st] += max(xs[st],0.0);
+			c[st] += (xs[st] >= 1.0) ? 1.0 : 0.0;
+		}
+	}
+#pragma omp simd
+	for (st=0;st<nSit;st++) c[st] = ((c[st] > 0) && (T[st] > 1.0)) ? 10.0*log(T[st])/c[st] : 0.0;
+	for (k=0;k<n;k++)
+	{
+		st = k % nSit;
+		d[k] = (T[st] > 0) ? max(x[k],0.0)/T[st] : 0.0;
+		predDens[k] = 0.0;
+		preyInd[k] = 0.0;
+		predInd[k] = 0.0;
+		bx[k] = 0.0;
+		dx[k] = 0.0;
+		dprey[k] = 0.0;
+		dpredOfprey[k] = 0.0;
+	}
+	for (sp=0;sp<nSpe;sp++)//sums over the predators (get_DensityPredOfPrey, get_NumberIndPredators)
+	{
+		for (k=this->predators_Offset[sp];k<this->predators_Offset[sp+1];k++)
+		{
+			p = this->predators_Index[k];
+#pragma omp simd
+			for (st=0;st<nSit;st++)
+			{
+				predDens[sp*nSit+st] += d[p*nSit+st];
+				predInd[sp*nSit+st] += max(x[p*nSit+st],0.0);
+			}
+		}
+	}
+	for (sp=0;sp<nSpe;sp++)//sums over the preys (calc_SOC_Densities, get_NumberIndPreys)
+	{
+		for (k=this->preys_Offset[sp];k<this->preys_Offset[sp+1];k++)
 		{
-			if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "MIGRATION (" << this->mc_timestep+1 << ") BEGINS HERE!" << endl;
-// 			if(this->mc_timestep==21) cerr << "ALE2.01: (t,#sp3)= \t" << this->mc_timestep << "\t" << this->_Sites.at(0).get_Nold(2)<<"\n";
-// 			if((this->mc_timestep==78 || this->mc_timestep==79) ){cerr << "ALE3.5 " <<" #sp(11)=" << this->_Sites.at(6).get_Nold(10)<< endl;} //ALE
-// 			if((this->mc_timestep==7 || this->mc_timestep==8)){cerr << "ALE4 Antes Mig  "<< " t:" << this->mc_timestep <<" #sp(4).Nnew=" << this->_Sites.at(6).get_Nnew(3)<< endl;} //ALE
-			this->Migration(realization);
-// 			if((this->mc_timestep==7 || this->mc_timestep==8)){cerr << "ALE4 Post  Mig  "<< " t:" << this->mc_timestep <<" #sp(4).Nnew=" << this->_Sites.at(6).get_Nnew(3)<< endl;} //ALE
-// 			if(this->mc_timestep==21) cerr << "ALE2.02: (t,#sp3)= \t" << this->mc_timestep << "\t" << this->_Sites.at(0).get_Nold(2)<<"\n";
+			q = this->preys_Index[k];
+#pragma omp simd
+			for (st=0;st<nSit;st++)
+			{
+				bx[sp*nSit+st] += d[q*nSit+st]*(1.0 - predDens[q*nSit+st]);
+				dx[sp*nSit+st] += predDens[q*nSit+st]*(1.0 - d[q*nSit+st]);
+				dprey[sp*nSit+st] += d[q*nSit+st];
+				dpredOfprey[sp*nSit+st] += predDens[q*nSit+st];
+				preyInd[sp*nSit+st] += max(x[q*nSit+st],0.0);
+			}
 		}
-// 		if((this->mc_timestep==78 || this->mc_timestep==79) ){cerr << "ALE4 " <<" #sp(11)=" << this->_Sites.at(6).get_Nold(10)<< endl;} //ALE
-		if(!(this->mc_timestep%this->show_each))
+	}
+	for (sp=0;sp<nSpe;sp++)//the rates: SOC_NDP, SOC_DP, SOC_BP and SOC_CC
+	{
+		nPreys = this->_Species.at(sp).get_NumberPreys();
+		nPred = this->_Species.at(sp).get_NumberPredators();
+#pragma omp simd private(k)
+		for (st=0;st<nSit;st++)
 		{
-// 		 if(this->mc_timestep==21) cerr << "ALE2.1: (t,#sp3)= \t" << this->mc_timestep << "\t" << this->_Sites.at(0).get_Nold(2)<<"\n";
-			this->acummulate_IndividualsSpecies(realization);
-			this->print_File(realization,space);
-// 			if(this->mc_timestep==21) cerr << "ALE2.2: (t,#sp3)= \t" << this->mc_timestep << "\t" << this->_Sites.at(0).get_Nold(2)<<"\n";
+			k = sp*nSit + st;
+			ndp[k] = ((nPred == 0) && (d[k] == 1.0)) ? 1.0 : d[k]*dx[k];
+			dp[k] = (nPreys > 0) ? d[k]*((nPred > 0) ? 1.0 - predDens[k] : 1.0)*dx[k] : 1.0;
+			bp[k] = (1.0 - d[k])*((nPreys > 0) ? bx[k] : 1.0)*(((nPred > 0) && (predDens[k] > 0)) ? 1.0 - predDens[k] : 1.0);
+			if (nPreys == 0) cc[k] = ccSite[st];
+			else if (dpredOfprey[k] > 0) cc[k] = floor(dprey[k]/dpredOfprey[k]);
+			else cc[k] = (T[st] > 0) ? floor(dprey[k]*T[st]) : 0.0;
 		}
-		if( (this->mc_timestep!=0)&&(!(this->mc_timestep%this->save_each)) )
+	}
+	for (sp=0;sp<nSpe;sp++)//natural deaths and births of the species without preys
+	{
+		nPreys = this->_Species.at(sp).get_NumberPreys();
+#pragma omp simd private(k,v)
+		for (st=0;st<nSit;st++)
 		{
-			for (sp=0;sp<(int)this->_Species.size();sp++) this->print_TimeSeriesOfSpecies(realization,space);
+			k = sp*nSit + st;
+			v = min(max(x[k],0.0),1.0);//alive (MonteCarlo_Site only chooses the species with nOld > 0)
+			A[k] = v*c[st]*(1.0 - ndp[k])*((preyInd[k] >= 1.0) ? floor(log(preyInd[k])) + 1.0 : 5.0);//rate of feeding
+			dxdt[k] = -v*c[st]*ndp[k];
+			if (nPreys == 0) dxdt[k] += A[k]*bp[k]*min(max(cc[k] - x[k],0.0),1.0);
+			eaten[k] = 0.0;
 		}
-		if((!(this->mc_timestep%this->tcn))&&((this->mc_timestep!=0)))
+	}
+	for (sp=0;sp<nSpe;sp++)//predations: the preys that die and the predators that are born
+	{
+		if (!this->_Species.at(sp).ver_IsPredator()) continue;
+		for (k=this->preys_Offset[sp];k<this->preys_Offset[sp+1];k++)
 		{
-			this->CoexistenceNetworks(realization,space);
+			q = this->preys_Index[k];
+#pragma omp simd private(v)
+			for (st=0;st<nSit;st++)
+			{
+				v = (preyInd[sp*nSit+st] > 0) ? A[sp*nSit+st]*max(x[q*nSit+st],0.0)/preyInd[sp*nSit+st]*dp[q*nSit+st] : 0.0;
+				dxdt[q*nSit+st] -= v;
+				eaten[sp*nSit+st] += v;
+			}
 		}
-// 		this->print_SOC_SpaceOfParameters(-1,realization);//breakline
-// 		if(this->mc_timestep==1000){this->print_SOC_SpaceOfParameters(-1,realization);} //ALE
-		if(this->mc_timestep==this->niter-1){this->print_SOC_SpaceOfParameters(-1,realization);} //ALE
-// 		cerr << "ALE: generé SOC\n";
-// 		if(this->mc_timestep==21 || this->mc_timestep==22) cerr << "ALE3: (t,#sp3)= \t" << this->mc_timestep << "\t" << this->_Sites.at(0).get_Nold(2)<<"\n";
-	}//iterations
-	
+#pragma omp simd private(k)
+		for (st=0;st<nSit;st++)
+		{
+			k = sp*nSit + st;
+			dxdt[k] += eaten[k]*bp[k]*min(max(cc[k] - x[k],0.0),1.0);
+		}
+	}
+	for (sp=0;sp<nSpe;sp++)//migrations, as in Migration: mp*x/tm to the preferred neighbors with vacancy
+	{
+		mp = this->_Species.at(sp).get_MigrationProbability()/(double)this->tm;
+		for (st=0;st<nSit;st++)
+		{
+			k = sp*nSit + st;
+			if (x[k] <= 0) continue;
+			sum = 0.0;
+			for (p=this->neigh_Offset[st];p<this->neigh_Offset[st+1];p++)
+			{
+				tg = sp*nSit + this->neigh_Index[p];
+				dif = ((preyInd[tg] - predInd[tg]) - (preyInd[k] - predInd[k]))*this->neigh_Weight[p];
+				if (dif > 0) sum += dif;
+			}
+			if (sum <= 0) continue;
+			for (p=this->neigh_Offset[st];p<this->neigh_Offset[st+1];p++)
+			{
+				tg = sp*nSit + this->neigh_Index[p];
+				dif = ((preyInd[tg] - predInd[tg]) - (preyInd[k] - predInd[k]))*this->neigh_Weight[p];
+				if ((dif <= 0) || (x[tg] >= cc[tg])) continue;
+				v = mp*x[k]*dif/sum*min(cc[tg] - x[tg],1.0);
+				dxdt[k] -= v;
+				dxdt[tg] += v;
+			}
+		}
+	}
+
 	return;
 }
 
-void Dynamic::DynamicPrey(int st, int sp, int cont)
+/*The SOC rates are kept for each site and species in the Abundance matrix. Species::data keeps, as before,
+ * the rates of the last site (in the order of the sites) where the SOC of the species was calculated, that
+ * are used by the Migration and the outputs.
+ * */
+void Dynamic::update_SpeciesData(void)
 {
-	int sum, i, prey, totIndsSP, ccSP, CantComidas, pario;
-	vector<int> auxIndex;//list of the indices of preys that has at least one individual alive
-	float prob; double totPop; int carryingCap;//ALE
+	int sp,st,i;
 
- if(cont==-1){ cerr << "#(sp:"<< sp+1 << ", st:" << st << ")= " << this->_Sites.at(st).get_Nold(sp) <<endl;} //ALE
-	if (this->_Species.at(sp).ver_IsPredator())//if species has a natural prey
+	for (sp=0;sp<(int)this->_Species.size();sp++)
 	{
-		if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "SPECIES " << sp+1 << " HAS A PREY!" << endl;
-		sum = 0;
-		auxIndex.clear();
-		for (i=0;i<this->_Species.at(sp).get_NumberPreys();i++)
+		for (st=(int)this->_Sites.size()-1;st>=0;st--)
 		{
-			if (this->_Sites.at(st).get_Nold(this->_Species.at(sp).get_Preys(i)-1) > 0)
+			i = this->_Abundance.ix(st,sp);
+			if (this->_Abundance.rate_Step[i] == this->mc_timestep)
 			{
-				auxIndex.push_back(this->_Species.at(sp).get_Preys(i));
-				sum+= this->_Sites.at(st).get_Nold(this->_Species.at(sp).get_Preys(i)-1);
+				this->_Species.at(sp).set_Data(this->_Abundance.rate_dp[i],this->_Abundance.rate_bp[i],this->_Abundance.rate_ndp[i],this->_Abundance.rate_mp[i],this->_Abundance.rate_cc[i]);
+				break;
 			}
 		}
+	}
+	return;
+}
+
+void Dynamic::DynamicPrey(int st, int sp, int cont)
+{
+	PROFILE_SCOPE(&this->profiler,PROFILE_PREY);
+	int prey, totIndsSP, ccSP, CantComidas, pario;
+	float prob; double totPop;//ALE
+
+ if(cont==-1){ cerr << "#(sp:"<< sp+1 << ", st:" << st << ")= " << this->_Sites.at(st).get_Nold(sp) <<endl;} //ALE
+	if (this->_Species.at(sp).ver_IsPredator())//if species has a natural prey
+	{
+		if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "SPECIES " << sp+1 << " HAS A PREY!" << endl;
 // 		CantComidas=floor(0.1*log(sum));
 // 		CantComidas=floor(0.5*sum);
 		CantComidas=1;
 		pario=0;
 		for(int comidas=1; comidas<=CantComidas; comidas++)  //Come Presas
 		{
-				prey = this->_Sites.at(st).get_RandomSpecies(cont,sum,auxIndex);//random choice among the preys that has at least one individual alive
+				prey = this->_Sites.at(st).get_RandomPrey(sp);//random choice among the preys that has at least one individual alive
 				if(cont==-1){ cerr << "<Presa> sp:"<< prey+1<<endl;} //ALE
 				if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "THE PREY IS: " << prey+1 << endl;
 				if (prey != -1)//that means that at least one individual of species 'prey' is alive
 				{
 					this->SOC(prey,st);//To change the Probabilities of the PREY to allow the PREDATION on MIGRATION
-					if ( this->_Species.at(prey).ver_Death(this->mc_timestep, (float)(random()%PRECISION)/PRECISION) ) //if the prey dies
+					if ( this->_Sites.at(st).ver_Death(prey, this->_Sites.at(st).get_RandomProbability()) ) //if the prey dies
 					{
 						this->_Sites.at(st).to_Die(prey);//decrease the number of individuals of species 'prey'
-		// 				if(this->_Sites.at(st).aux_ListSpecies.at(prey)) this->_Sites.at(st).aux_ListSpecies.at(prey)--; //ALE
-						this->_Sites.at(st).MCdata.at(prey)--;  //ALE
+						PROFILE_COUNT(&this->profiler,PROFILE_PREDATIONS,1);
 						if(cont==-1){ cerr << "<Presa Muere> "<<endl;} //ALE
 						if(cont==-1){ cerr << "<Quedan> #sp("<< prey+1 <<"): "<< this->_Sites.at(st).get_Nold(prey) <<endl;} //ALE
 		//ALE				if ( this->_Species.at(sp).ver_Birth(this->mc_timestep, (float)(random()%PRECISION)/PRECISION) )//if the species borns, when the species has a prey
-						prob=(float)(random()%PRECISION)/PRECISION;
+						prob=this->_Sites.at(st).get_RandomProbability();
 						totPop=this->_Sites.at(st).get_TotalPopulation();
 						totIndsSP=this->_Sites.at(st).get_NumberIndSpecies(sp);
-						ccSP=this->_Species.at(sp).get_CC();
-						carryingCap=this->_Sites.at(st).get_CarryingCapacity();
+						ccSP=this->_Sites.at(st).get_SpeciesCC(sp);
 						if(cont==-1){cerr << "<Prob>: " << prob << " cc: "<<ccSP<<" totPop: "<< totPop <<endl;} //ALE
 		// 				if ( this->_Species.at(sp).ver_Birth(this->mc_timestep, prob ) && ((prob<(carryingCap-totPop)/(float)carryingCap)) )
 		// 				if ( this->_Species.at(sp).ver_Birth(this->mc_timestep, prob ) )  //ALE1
 		// 				if ( this->_Species.at(sp).ver_Birth(this->mc_timestep, prob ) && (prob < ( ccSP - totIndsSP)/(float)ccSP) ) //ALE2
-						if ( this->_Species.at(sp).ver_Birth(this->mc_timestep, prob ) && (ccSP > totIndsSP) && !pario) //ALE3
+						if ( this->_Sites.at(st).ver_Birth(sp, prob ) && (ccSP > totIndsSP) && !pario) //ALE3
 										
 		// 				    (prob < (this->_Species.at(sp).get_CC() - this->_Sites.at(st).get_NumberIndSpecies(sp))/(float)this->_Species.at(sp).get_CC()) ) //ALE2
 		//ALE
@@ -999,6 +2151,7 @@ void Dynamic::DynamicPrey(int st, int sp, int cont)
 		// 				 cerr << "ALE: NACE PREDADOR  (cc= " << ccSP << "; totSP= " << totIndsSP << ")\n";
 							if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "TO BORN!" << endl;
 							this->_Sites.at(st).to_Born(sp);
+							PROFILE_COUNT(&this->profiler,PROFILE_BIRTHS,1);
 							pario=1;
 						}
 					}
@@ -1012,18 +2165,19 @@ void Dynamic::DynamicPrey(int st, int sp, int cont)
 		if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "POP: " << this->_Sites.at(st).get_TotalPopulation() << endl;
 // 		if (this->_Sites.at(st).get_CarryingCapacity() > this->_Sites.at(st).get_TotalPopulation())//verifying the carrying capacity of the site!
   totIndsSP=this->_Sites.at(st).get_NumberIndSpecies(sp);
-  ccSP=this->_Species.at(sp).get_CC();
+  ccSP=this->_Sites.at(st).get_SpeciesCC(sp);
 // 		if (this->_Species.at(sp).get_CC() > this->_Sites.at(st).get_NumberIndSpecies(sp))//verifying the carrying capacity of the site! //ALE1
 // 		if(1)  //(totIndsSP < ccSP) //verifying the carrying capacity of the site! //ALE2
 		// ALE no verifico cc para las presas primarias!!!
 		if(totIndsSP < ccSP) //verifying the carrying capacity of the site! //ALE2
 		{
-			if ( this->_Species.at(sp).ver_Birth(this->mc_timestep, (float)(random()%PRECISION)/PRECISION) )//if the species borns, even when the species doesnt have a prey 
+			if ( this->_Sites.at(st).ver_Birth(sp, this->_Sites.at(st).get_RandomProbability()) )//if the species borns, even when the species doesnt have a prey 
 			{
 /*			 if(totIndsSP<0) cerr << "ALE: NACE PRESA sp:"<< sp+1 << "@ s:" << st << "@t:"<< this->mc_timestep <<" (cc= " << ccSP << "; totSP= " << 
 			 		totIndsSP << " [" << this->_Sites.at(st).get_Nold(sp) << ";" << this->_Sites.at(st).get_Nnew(sp) << "]" <<")\n";*/
 				if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "TO BORN!" << endl;
 				this->_Sites.at(st).to_Born(sp);
+				PROFILE_COUNT(&this->profiler,PROFILE_BIRTHS,1);
 			}
 //			else
 //			{
@@ -1040,19 +2194,12 @@ void Dynamic::DynamicPrey(int st, int sp, int cont)
 
 int Dynamic::get_NumberIndPreys(int st,int sp)
 {
-	int prey,i,j,sum;
+	int i,sum;
 
 	sum=0;
-	for (i=0;i<this->_Species.at(sp).get_NumberPreys();i++)
+	for (i=this->preys_Offset[sp];i<this->preys_Offset[sp+1];i++)
 	{
-		prey = this->_Species.at(sp).get_Preys(i);
-		for (j=0;j<this->_Sites.at(st).get_NumberSpecies();j++)
-		{
-			if (this->_Sites.at(st).get_IdSpecies(j) == prey)
-			{
-				sum+= this->_Sites.at(st).get_Nold(j);
-			}
-		}
+		sum+= this->_Sites[st].get_Nold(this->preys_Index[i]);
 	}
 
 	return(sum);
@@ -1060,19 +2207,12 @@ int Dynamic::get_NumberIndPreys(int st,int sp)
 
 int Dynamic::get_NumberIndPredators(int st,int sp)
 {
-	int predator,i,j,sum;
+	int i,sum;
 
 	sum=0;
-	for (i=0;i<this->_Species.at(sp).get_NumberPredators();i++)
+	for (i=this->predators_Offset[sp];i<this->predators_Offset[sp+1];i++)
 	{
-		predator = this->_Species.at(sp).get_Predators(i);
-		for (j=0;j<this->_Sites.at(st).get_NumberSpecies();j++)//index is different from id. Need to change vector by binary tree
-		{
-			if (this->_Sites.at(st).get_IdSpecies(j) == predator)
-			{
-				sum+= this->_Sites.at(st).get_Nold(j);
-			}
-		}
+		sum+= this->_Sites[st].get_Nold(this->predators_Index[i]);
 	}
 
 	return(sum);
@@ -1080,16 +2220,20 @@ int Dynamic::get_NumberIndPredators(int st,int sp)
 
 void Dynamic::Migration(int cont)
 {
+	PROFILE_SCOPE(&this->profiler,PROFILE_MIGRATION);
 	int i,j,k,ix_St1,ix_Sp1,ix_TargetSt;
-	int sum,number_mig,realMigration,threshold_mig,i_nmig;
+	int sum,number_mig,realMigration,threshold_mig;
 	float dif;
-	tNeighborhood auxNeigh;
-	int nSitesOrdered, nSpeciesOrdered, nNeigh;
-	ofstream f1;
+	int nSitesOrdered, nSpeciesOrdered;
 
-	f1.open("realMigration.dat",ofstream::app);
+	if (this->migration == MIGRATION_TWOPHASE)
+	{
+		this->Migration_TwoPhase();
+		return;
+	}
 	this->reorder_Sites();
 	this->set_Pref();
+	this->calc_MigrationSums();
 	nSitesOrdered = (int)this->sitesOrdered.size();
 	for (i=0;i<nSitesOrdered;i++)//loop of the sites
 	{
@@ -1100,20 +2244,18 @@ void Dynamic::Migration(int cont)
 		{
 			ix_Sp1 = this->_Sites.at(ix_St1).get_SpeciesOrdered(j)-1;
 			if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "SPECIES SELECTED: " << ix_Sp1+1 << endl;
-			sum=this->calc_SumN(ix_St1,ix_Sp1);//to calculate de sum of the [ P_ix_St1(s)-Pj(s) ]*w_ix_St1-j
+			sum=this->migration_Sum[this->_Abundance.ix(ix_St1,ix_Sp1)];//the sum of the [ Pj(s)-P_ix_St1(s) ]*w_ix_St1-j
 			realMigration =0;
 // 			if( mc_timestep==7 && ix_Sp1 == 3 && (ix_St1==6))
 /*			if( mc_timestep==7 && ix_St1==86) 
 					cerr << "ALE4 Durante Mig 0  "<< " t:"  << this->mc_timestep << " ST:" << ix_St1
 			    << " SP:" << ix_Sp1+1  <<" #sp(4).Nnew=" << this->_Sites.at(6).get_Nnew(3)<< endl; //ALE*/
 // 			if (sum != 0)//if there are preffered sites
-			if (sum != 0 && this->_Sites.at(ix_St1).get_Nold(ix_Sp1) )//if there are inds of the species at site and there are preffered sites			
+			if (sum != 0 && this->_Sites.at(ix_St1).get_Nold(ix_Sp1) && this->ver_MigrationVacancy(ix_St1,ix_Sp1))//if there are inds of the species at site and there are preffered sites			
 			{
-				nNeigh = this->_Sites.at(ix_St1).get_NumberNeigh();
-				for (k=0;k<nNeigh;k++)//number_mig is the number of migrations for species 'ix_Sp1', from site 'ix_St1' to site 'ix_TargetSt'.
+				for (k=this->neigh_Offset[ix_St1];k<this->neigh_Offset[ix_St1+1];k++)//number_mig is the number of migrations for species 'ix_Sp1', from site 'ix_St1' to site 'ix_TargetSt'.
 				{
-					auxNeigh = this->_Sites.at(ix_St1).get_NeighborhoodData(k);
-					ix_TargetSt = auxNeigh.id-1;			
+					ix_TargetSt = this->neigh_Index[k];			
 					
 /*					if( mc_timestep==21 && ix_Sp1 == 2 && (ix_St1==0 || ix_TargetSt==0)) cerr << "ALE <MIG_1> sp:" << ix_Sp1+1 
 								<< "["<< this->_Sites.at(ix_St1).get_Nold(2) << "->" << this->_Sites.at(ix_TargetSt).get_Nold(2) << "]:  " 
@@ -1126,7 +2268,7 @@ void Dynamic::Migration(int cont)
 								
 					
 					if((mc_timestep>=it_beg)&&(mc_timestep<=it_end)) cout << endl << "MIGRATION OF SPECIES_" << ix_Sp1+1 << " FROM SITE " << ix_St1+1 << " TO SITE " << ix_TargetSt+1 << ": " << endl;	
-					dif = ((this->_Sites.at(ix_TargetSt).get_Pref(ix_Sp1) - this->_Sites.at(ix_St1).get_Pref(ix_Sp1))*this->_Sites.at(ix_St1).get_NeighborhoodData(k).weight);
+					dif = ((this->_Sites.at(ix_TargetSt).get_Pref(ix_Sp1) - this->_Sites.at(ix_St1).get_Pref(ix_Sp1))*this->neigh_Weight[k]);
 					
 // 					if( mc_timestep==21 && ix_Sp1 == 2 && (ix_St1==0 || ix_TargetSt==0)) cerr << "ALE <MIG_1.1> dif:" << dif << endl;
 					
@@ -1139,7 +2281,7 @@ void Dynamic::Migration(int cont)
 						if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << number_mig << endl;
 // 						threshold_mig = this->_Sites.at(ix_TargetSt).get_CarryingCapacity() - this->_Sites.at(ix_TargetSt).get_TotalPopulation();//maximum number of individuals that can migrate to this site
 // 						threshold_mig = this->_Sites.at(ix_TargetSt).get_CC(ix_Sp1)-this->_Sites.at(ix_TargetSt).get_NumberIndSpecies(ix_Sp1);  //ALE
-						threshold_mig = this->SOC_CC(ix_Sp1,ix_TargetSt)-this->_Sites.at(ix_TargetSt).get_NumberIndSpecies(ix_Sp1);  //ALE
+						threshold_mig = this->get_RateCC(ix_Sp1,ix_TargetSt)-this->_Sites.at(ix_TargetSt).get_NumberIndSpecies(ix_Sp1);  //ALE
 						
 // 						if( mc_timestep==21 && ix_Sp1 == 2 && (ix_St1==0 || ix_TargetSt==0)) cerr << "ALE <MIG_1.2> number_mig:" << number_mig << endl;
 // 						if( mc_timestep==21 && ix_Sp1 == 2 && (ix_St1==0 || ix_TargetSt==0)) cerr << "ALE <MIG_1.3> threshold_mig:" << threshold_mig << endl;
@@ -1162,12 +2304,16 @@ void Dynamic::Migration(int cont)
 							else if (number_mig < threshold_mig)//There is vacancy in the TARGET SITE - Then we migrate all the required individuals
 							{
 								realMigration += number_mig;
+								this->_Flows.add_Flow(k,ix_Sp1,number_mig);
+								PROFILE_COUNT(&this->profiler,PROFILE_MIGRATIONS,number_mig);
 								this->_Sites.at(ix_TargetSt).set_Nnew(ix_Sp1,this->_Sites.at(ix_TargetSt).get_Nnew(ix_Sp1)+number_mig);//increase the individuals in site 'ix_TargetSt' to the NEW individuals
 								if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "HAS MIGRATE " << number_mig << " INDIVIDUALS OF SPECIES " << ix_Sp1+1 << " FROM SITE " << ix_St1+1 << " TO SITE " << ix_TargetSt+1 << endl;
 							}
 							else//There is not so much vacancy in the TARGET SITE - Then we just migrate threshold_mig individuals 
 							{
 								realMigration += threshold_mig;
+								this->_Flows.add_Flow(k,ix_Sp1,threshold_mig);
+								PROFILE_COUNT(&this->profiler,PROFILE_MIGRATIONS,threshold_mig);
 								this->_Sites.at(ix_TargetSt).set_Nnew(ix_Sp1,this->_Sites.at(ix_TargetSt).get_Nnew(ix_Sp1)+(threshold_mig));//increase the individuals in site 'ix_TargetSt'
 								if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "HAS MIGRATE " << threshold_mig << " INDIVIDUALS OF SPECIES " << ix_Sp1+1 << " FROM SITE " << ix_St1+1 << " TO SITE " << ix_TargetSt+1 << endl;	
 							}
@@ -1195,89 +2341,249 @@ void Dynamic::Migration(int cont)
 					cerr << "ALE4 Durante Mig 3  "<< " t:"  << this->mc_timestep << " ST:" << ix_St1
 			    << " SP:" << ix_Sp1+1  <<" #sp(4).Nnew=" << this->_Sites.at(6).get_Nnew(3)<< endl; //ALE*/
 		}
-		f1 << realMigration << " ";		
 		if((mc_timestep>=it_beg)&&(mc_timestep<=it_end)) cout << endl;
 	}
-	f1 << endl;
 
 	return;
 }
 
-int Dynamic::calc_SumN(int st, int sp)
+/*Migration with MIGRATION_TWOPHASE. No individual moves until all the flows are known, so each phase is a parallel
+ * loop in which each site only writes its own data:
+ * 1. the Pref and the rates (SOC_Site) of each site, with the individuals before the migration
+ * 2. request_Migrations - the individuals of each species that each site wants to send to each neighbor
+ * 3. accept_Migrations - each target takes the requests while it has room, by the order of their sources in
+ *    sitesOrdered (shuffled by reorder_Sites at each migration)
+ * 4. each source loses the individuals that were accepted
+ * */
+void Dynamic::Migration_TwoPhase(void)
 {
-	int k,sum,ix_TargetSt,pref1,pref3,pop,ok;
-	tNeighborhood auxNeigh;
-	int totIndsSpAtTarget, ccSpAtTarget;
+	int i,st,sp,k,nSit,nSpe,nEdges,left;
 
-	sum=0;
-	ok=0;
-	if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "NUMBER OF NEIGHBORHOODS: "<< this->_Sites.at(st).get_NumberNeigh() << endl;
-	for (k=0;k<this->_Sites.at(st).get_NumberNeigh();k++)//calculate the number of individuals from specie j that will migrate from site i to site k
-	{
-		auxNeigh = this->_Sites.at(st).get_NeighborhoodData(k);
-		ix_TargetSt = auxNeigh.id-1;
-		pop=this->_Sites.at(ix_TargetSt).get_TotalPopulation();
-		if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "CC  = " << this->_Sites.at(st).get_CarryingCapacity() << endl;
-		if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "POP = " << pop << endl;
-		
-		ccSpAtTarget=this->SOC_CC(sp,ix_TargetSt);
-		totIndsSpAtTarget=this->_Sites.at(st).get_NumberIndSpecies(sp);
-		
-// 		if (pop < this->_Sites.at(st).get_CarryingCapacity())//at least one site has vacancy
-		if( totIndsSpAtTarget < ccSpAtTarget)  //ALE
+	nSit = (int)this->_Sites.size();
+	nSpe = (int)this->_Species.size();
+	nEdges = (int)this->neigh_Index.size();
+	this->reorder_Sites();
+	this->migration_Rank.resize(nSit);
+	for (i=0;i<nSit;i++) this->migration_Rank[this->sitesOrdered[i]-1] = i;
+	this->migration_Flow.assign(nSpe*nEdges,0);
+	this->migration_Order.resize(nEdges);
+#pragma omp parallel for
+	for (st=0;st<nSit;st++)
+	{
+		this->calc_PrefSite(st);
+		this->SOC_Site(st);
+	}
+	this->calc_MigrationSums();
+#pragma omp parallel for schedule(dynamic)
+	for (st=0;st<nSit;st++) this->request_Migrations(st);
+#pragma omp parallel for schedule(dynamic)
+	for (st=0;st<nSit;st++) this->accept_Migrations(st);
+#pragma omp parallel for private(sp,k,left)
+	for (st=0;st<nSit;st++)
+	{
+		for (sp=0;sp<nSpe;sp++)
 		{
-			if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "OK! WE HAVE VACANCY!" << endl;	
-			ok = 1;
+			left = 0;
+			for (k=this->neigh_Offset[st];k<this->neigh_Offset[st+1];k++)
+			{
+				left += this->migration_Flow[sp*nEdges + k];
+				if (this->migration_Flow[sp*nEdges + k]) this->_Flows.add_Flow(k,sp,this->migration_Flow[sp*nEdges + k]);//(each site only adds its own edges)
+			}
+			if (left) this->_Sites[st].set_Nold(sp,this->_Sites[st].get_Nold(sp) - left);
+			PROFILE_COUNT(&this->profiler,PROFILE_MIGRATIONS,left);
 		}
-		pref1 = this->_Sites.at(st).get_Pref(sp);
-		pref3 = this->_Sites.at(ix_TargetSt).get_Pref(sp);
-		if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "PREFERED(" << st+1 << ") = " << pref1 << endl;
-		if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "PREFERED(" << ix_TargetSt+1 << ") = " << pref3 << endl;
-		if (pref3 > pref1)
+	}
+
+	return;
+}
+
+/*The individuals of each species that 'st' wants to send to each neighbor (migration_Flow), with the rules of
+ * Migration but only with the individuals before the migration. The rates of all the sites are up to date
+ * (Migration_TwoPhase), so get_RateCC only reads them
+ * */
+void Dynamic::request_Migrations(int st)
+{
+	int sp,k,tg,sum,nOld,wanted,number_mig,threshold_mig,nEdges;
+	float dif;
+
+	nEdges = (int)this->neigh_Index.size();
+	for (sp=0;sp<(int)this->_Species.size();sp++)
+	{
+		sum = this->migration_Sum[this->_Abundance.ix(st,sp)];
+		nOld = this->_Sites[st].get_Nold(sp);
+		if ((sum == 0) || (nOld == 0) || (!this->ver_MigrationVacancy(st,sp))) continue;
+		wanted = 0;
+		for (k=this->neigh_Offset[st];k<this->neigh_Offset[st+1];k++)
 		{
-			if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "SUM = " << sum << " ---> ";
-			sum+=((pref3 - pref1)*this->_Sites.at(st).get_NeighborhoodData(k).weight);
-			if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "SUM = " << sum << endl;
+			tg = this->neigh_Index[k];
+			dif = ((this->_Sites[tg].get_Pref(sp) - this->_Sites[st].get_Pref(sp))*this->neigh_Weight[k]);
+			if (dif <= 0) continue;
+			number_mig = (int) (this->_Species[sp].get_MigrationProbability() * (nOld - wanted) * dif/sum);
+			threshold_mig = this->get_RateCC(sp,tg) - this->_Sites[tg].get_NumberIndSpecies(sp);
+			if (number_mig > threshold_mig) number_mig = threshold_mig;
+			if (number_mig > nOld - wanted) number_mig = nOld - wanted;
+			if (number_mig <= 0) continue;
+			this->migration_Flow[sp*nEdges + k] = number_mig;
+			wanted += number_mig;
 		}
-//		else
-//		{
-//			if((this->mc_timestep>=it_beg)&&(this->mc_timestep<=it_end)) cout << "IT'S NOT A PREFER! SO, SUM = " << sum << endl;
-//		}
 	}
 
-	if (!(ok))sum=0;//in case of all the neighborhoods are full - WE ARE NOT USING THAT YET
+	return;
+}
 
-	return(sum);
+/*The requests that arrive at 'tg', accepted by the order of their sources in sitesOrdered while the species has room
+ * (SOC_CC minus its individuals, before the migration). What is not accepted stays at the source
+ * */
+void Dynamic::accept_Migrations(int tg)
+{
+	int i,j,e,sp,nSpe,nEdges,first,last,room,in;
+	int *order,*flow;
+
+	first = this->neigh_InOffset[tg];
+	last = this->neigh_InOffset[tg+1];
+	if (first == last) return;
+	nSpe = (int)this->_Species.size();
+	nEdges = (int)this->neigh_Index.size();
+	order = &this->migration_Order[0];
+	for (i=first;i<last;i++)//insertion sort of the edges by the rank of their sources
+	{
+		e = this->neigh_InEdge[i];
+		for (j=i;(j>first)&&(this->migration_Rank[this->neigh_Source[order[j-1]]] > this->migration_Rank[this->neigh_Source[e]]);j--) order[j] = order[j-1];
+		order[j] = e;
+	}
+	for (sp=0;sp<nSpe;sp++)//first all the species with the rates before the migration (set_Nnew changes them)
+	{
+		flow = &this->migration_Flow[sp*nEdges];
+		room = this->get_RateCC(sp,tg) - this->_Sites[tg].get_NumberIndSpecies(sp);
+		in = 0;
+		for (i=first;i<last;i++)
+		{
+			e = order[i];
+			if (flow[e] > room - in) flow[e] = (room - in > 0) ? room - in : 0;
+			in += flow[e];
+		}
+	}
+	for (sp=0;sp<nSpe;sp++)
+	{
+		flow = &this->migration_Flow[sp*nEdges];
+		in = 0;
+		for (i=first;i<last;i++) in += flow[order[i]];
+		if (in) this->_Sites[tg].set_Nnew(sp,this->_Sites[tg].get_Nnew(sp) + in);
+	}
 
+	return;
 }
 
-void Dynamic::set_Pref(void)
+/*The sums of the positive [ Pj(s)-Pi(s) ]*w_i-j of all the sites and species, with the Pref of set_Pref (they
+ * don't change during the migrations). Each species is one pass over the landscape in CSR
+ * */
+void Dynamic::calc_MigrationSums(void)
 {
-	int i,j,ix_St1,ix_Sp1;//,dif;
-	float dif;
+	int sp,st,k,nSit,nSpe,sum,d;
+	const int *pref,*offset,*index,*weight;
+	int *out;
 
-	for (i=0;i<(int)this->sitesOrdered.size();i++)//for each site, in a reordered sequence
+	nSit = (int)this->_Sites.size();
+	nSpe = (int)this->_Species.size();
+	this->migration_Sum.resize(nSit*nSpe);
+	if (this->neigh_Index.empty())
 	{
-		ix_St1 = this->sitesOrdered.at(i)-1;
-		this->_Sites.at(ix_St1).reorder_Species();
-		for (j=0;j<this->_Sites.at(ix_St1).get_NumberSpeciesOrdered();j++)//for each species, in a reordered sequence
+		this->migration_Sum.assign(nSit*nSpe,0);
+		return;
+	}
+	offset = &this->neigh_Offset[0];
+	index = &this->neigh_Index[0];
+	weight = &this->neigh_Weight[0];
+	for (sp=0;sp<nSpe;sp++)
+	{
+		pref = &this->_Abundance.pref[sp*nSit];
+		out = &this->migration_Sum[sp*nSit];
+		for (st=0;st<nSit;st++)
 		{
-			ix_Sp1 = this->_Sites.at(ix_St1).get_SpeciesOrdered(j)-1;
-// 			dif = this->get_NumberIndPreys(ix_St1,ix_Sp1) - this->get_NumberIndPredators(ix_St1,ix_Sp1);
-			dif = this->get_NumberIndPreys(ix_St1,ix_Sp1) - this->get_NumberIndPredators(ix_St1,ix_Sp1);
-			this->_Sites.at(ix_St1).set_Pref(ix_Sp1,dif);
+			sum = 0;
+#pragma omp simd reduction(+:sum) private(d)
+			for (k=offset[st];k<offset[st+1];k++)
+			{
+				d = pref[index[k]] - pref[st];
+				sum += (d > 0) ? d*weight[k] : 0;
+			}
+			out[st] = sum;
 		}
 	}
+
+	return;
+}
+
+/*1 if the individuals of 'sp' at 'st' are less than the carrying capacity of 'sp' at any neighbor (the rates
+ * of the neighbors are kept between the calls, see get_RateCC)
+ * */
+int Dynamic::ver_MigrationVacancy(int st, int sp)
+{
+	int k,n;
+
+	n = this->_Sites.at(st).get_NumberIndSpecies(sp);
+	for (k=this->neigh_Offset[st];k<this->neigh_Offset[st+1];k++)
+	{
+		if (n < this->get_RateCC(sp,this->neigh_Index[k])) return(1);
+	}
+
+	return(0);
+}
+
+/*The order of the species of each site for Migration (reorder_Species) and their Pref, all the sites at the same time
+ * */
+void Dynamic::set_Pref(void)
+{
+	PROFILE_SCOPE(&this->profiler,PROFILE_PREF);
+	int st;
+
+#pragma omp parallel for schedule(dynamic)
+	for (st=0;st<(int)this->_Sites.size();st++)//each site only uses its own random numbers, so the order doesn't matter
+	{
+		this->_Sites[st].reorder_Species();
+		this->calc_PrefSite(st);
+	}
+	return;
+}
+
+/*The Pref (#ofpreys - #ofpredators, with Nold) of all the species of the site 'st': the product of the food web with
+ * the preys positive and the predators negative (pref_Index, pref_Sign) by the individuals of the site
+ * */
+void Dynamic::calc_PrefSite(int st)
+{
+	int sp,k,nSit,nSpe,p;
+	const int *nOld,*index,*sign;
+
+	nSit = (int)this->_Sites.size();
+	nSpe = (int)this->_Species.size();
+	if (this->pref_Index.empty())//there are no links
+	{
+		for (sp=0;sp<nSpe;sp++) this->_Abundance.pref[this->_Abundance.ix(st,sp)] = 0;
+		return;
+	}
+	nOld = &this->_Abundance.nOld[st];//the species 'q' of the site is nOld[q*nSit]
+	index = &this->pref_Index[0];
+	sign = &this->pref_Sign[0];
+	for (sp=0;sp<nSpe;sp++)
+	{
+		p = 0;
+#pragma omp simd reduction(+:p)
+		for (k=this->pref_Offset[sp];k<this->pref_Offset[sp+1];k++) p += sign[k]*nOld[index[k]*nSit];
+		this->_Abundance.pref[this->_Abundance.ix(st,sp)] = p;
+	}
+
 	return;
 }
 
+/*Fisher-Yates shuffle of the sites
+ * */
 void Dynamic::reorder_Sites(void)
 {
 	int num,aux,i;
 	
-	for (i=0;i<(int)this->_Sites.size();i++)
+	for (i=(int)this->sitesOrdered.size()-1;i>0;i--)
 	{
-		while ((num=random()%this->_Sites.size())==i);		
+		num = this->rng.get_Int(i+1);
 		aux=this->sitesOrdered.at(i);
 		this->sitesOrdered.at(i) = this->sitesOrdered.at(num);
 		this->sitesOrdered.at(num) = aux;
@@ -1319,6 +2625,7 @@ void Dynamic::print_Variables(int st)
 
 void Dynamic::print_File(int realization, int changes)
 {
+	PROFILE_SCOPE(&this->profiler,PROFILE_PRINT);
 		//defining the name of the output file
 //	if (this->mc_timestep < 9) 
 //	{
@@ -1363,183 +2670,175 @@ void Dynamic::print_File(int realization, int changes)
 //	//
 //	f1.open(os1.str().c_str());
 
-	int st,sp;
-	ofstream f1;
-	ostringstream os2,os3,os4;
-	vector<string> names_OutputFile;	
+	int sp;
 
-	os2 << "output_species_00";
-	os3 << "output_species_0";
-	os4 << "output_species_";
-	for (sp=0;sp<(int)this->_Species.size();sp++)
+	if (!this->_Output.is_Open(this->seed,realization,changes))
 	{
-		ostringstream os1;
-		if(sp<9) os1 << os2.str() << sp+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << changes << ".dat";
-		else if((sp>=9)&&(sp<99)) os1 << os3.str() << sp+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << changes << ".dat";
-		else if((sp>=99)&&(sp<999)) os1 << os4.str() << sp+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << changes << ".dat";
-		names_OutputFile.push_back(os1.str());
-		os1.str().erase();
+		this->_Output.open(this->dir_Output,this->seed,realization,changes,(int)this->_Species.size(),(int)this->_Sites.size());
 	}
+	this->_Output.begin_Sample(this->mc_timestep);
 	for (sp=0;sp<(int)this->_Species.size();sp++)
 	{
-		f1.open(names_OutputFile.at(sp).c_str(),ofstream::app);
-		for (st=0;st<(int)this->_Sites.size();st++)
-		{
-			f1 << this->_Sites.at(st).get_NumberIndSpecies(sp) << " ";
-		}
-		f1 << endl;
-		f1.close();
-	}			
+		this->_Output.add_Sample(this->mc_timestep,sp,this->_Abundance.get_IndividualsOfSpecies(sp),(int)this->_Sites.size());
+	}
+	this->_Output.end_Sample();//the files are written only when the buffers are big
 	return;
 }
 
+/*The coexistence networks of the current iteration. With COEXISTENCE_TABLE all the weights of each pair of species
+ * are written as the columns of only one file, overlapping_NNNNN_seed_S_real_R_changes_C.dat (the pairs without any
+ * weight above coexistence_Threshold are skipped). With COEXISTENCE_PAJEK each weight is written in its own Pajek file,
+ * overlapping_NNNNN_seed_S_real_R_changes_C_K.net (K = 1..8).
+ * */
 void Dynamic::CoexistenceNetworks(int realization, int space)
 {
-	ofstream f1, f2, f3, f4, f5, f6,f7,f8;
-	int sp1,sp2,st,nSpe,nSit;
-	int total1,total2,nInd1,nInd2;
-	int sum1,sum2,sum3,sum6_1,sum6_2,sum8_1,sum8_2,step_1,step_2,step_12;
+	PROFILE_SCOPE(&this->profiler,PROFILE_COEXISTENCE);
+	ofstream f1, f2, f3, f4, f5, f6,f7,f8,f9;
+	int sp1,sp2,st,nSpe,nSit,k,pajek,table;
+	int total1,total2,both1,both2,nWords,w;
+	int *n1,*n2;
+	int sum1,sum2,sum3,sum6_1,sum6_2,sum8_1,sum8_2;
 	float sum4,sum5;
 	float Dasym_12, Dasym_21, DNMasym_12=0.0, DNMasym_21=0.0;
-	ostringstream os1, os2, os3, os4, os5, os6, os7, os8;
-
-	if (this->mc_timestep < 9) 
-	{
-		os1 << "overlapping_0000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_1.net";
-		os2 << "overlapping_0000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_2.net";
-		os3 << "overlapping_0000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_3.net";
-		os4 << "overlapping_0000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_4.net";
-		os5 << "overlapping_0000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_5.net";
-		os6 << "overlapping_0000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_6.net";
-		os7 << "overlapping_0000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_7.net";
-		os8 << "overlapping_0000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_8.net";
-	}
-	else if ((this->mc_timestep < 99)&&(this->mc_timestep >=9))
-	{
-		 os1 << "overlapping_000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_1.net";
-		 os2 << "overlapping_000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_2.net";
-		 os3 << "overlapping_000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_3.net";
-		 os4 << "overlapping_000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_4.net";
-		 os5 << "overlapping_000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_5.net";
-		 os6 << "overlapping_000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_6.net";
-		 os7 << "overlapping_000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_7.net";
-		 os8 << "overlapping_000" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_8.net";
-	}
-	else if ((this->mc_timestep < 999)&&(this->mc_timestep >=99))
-	{
-		 os1 << "overlapping_00" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_1.net";
-		 os2 << "overlapping_00" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_2.net";
-		 os3 << "overlapping_00" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_3.net";
-		 os4 << "overlapping_00" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_4.net";
-		 os5 << "overlapping_00" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_5.net";
-		 os6 << "overlapping_00" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_6.net";
-		 os7 << "overlapping_00" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_7.net";
-		 os8 << "overlapping_00" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_8.net";
-	}
-	else if ((this->mc_timestep < 9999)&&(this->mc_timestep >=999))
-	{
-		 os1 << "overlapping_0" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_1.net";
-		 os2 << "overlapping_0" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_2.net";
-		 os3 << "overlapping_0" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_3.net";
-		 os4 << "overlapping_0" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_4.net";
-		 os5 << "overlapping_0" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_5.net";
-		 os6 << "overlapping_0" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_6.net";
-		 os7 << "overlapping_0" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_7.net";
-		 os8 << "overlapping_0" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_8.net";
-	}
-	else if ((this->mc_timestep < 99999)&&(this->mc_timestep >=9999))
-	{
-		 os1 << "overlapping_" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_1.net";
-		 os2 << "overlapping_" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_1.net";
-		 os3 << "overlapping_" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_1.net";
-		 os4 << "overlapping_" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_1.net";
-		 os5 << "overlapping_" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_5.net";
-		 os6 << "overlapping_" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_6.net";
-		 os7 << "overlapping_" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_7.net";
-		 os8 << "overlapping_" << this->mc_timestep+1 << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space << "_8.net";
-	}
-	
-	f1.open(os1.str().c_str()); f2.open(os2.str().c_str()); f3.open(os3.str().c_str()); f4.open(os4.str().c_str()); f5.open(os5.str().c_str()); f6.open(os6.str().c_str()); f7.open(os7.str().c_str()); f8.open(os8.str().c_str());
+	float weight[8];
+	uint64_t both,overlap;
+	vector<uint64_t> aliveMap,presentMap;
+	vector<int> total,alive;
+	vector<float> limit;
+	ofstream *pajekFile[8] = {&f1,&f2,&f3,&f4,&f5,&f6,&f7,&f8};
+	char num[16];
+	ostringstream prefix;
+
+	pajek = this->coexistence_Layout & COEXISTENCE_PAJEK;
+	table = this->coexistence_Layout & COEXISTENCE_TABLE;
+	if ((!pajek)&&(!table)) return;
+	sprintf(num,"%05d",this->mc_timestep+1);
+	prefix << "overlapping_" << num << "_seed_" << this->seed << "_real_" << realization << "_changes_" << space;
 	nSpe = (int)this->_Sites.at(0).get_NumberSpecies();
 	nSit = (int)this->_Sites.size();
-	f1 << "*Vertices " << nSpe << endl; f2 << "*Vertices " << nSpe << endl; f3 << "*Vertices " << nSpe << endl; f4 << "*Vertices " << nSpe << endl; f5 << "*Vertices " << nSpe << endl; f6 << "*Vertices " << nSpe << endl; f7 << "*Vertices " << nSpe << endl; f8 << "*Vertices " << nSpe << endl;
-	for (sp1=0;sp1<nSpe;sp1++)
+	if (pajek)
+	{
+		for (k=0;k<8;k++)
+		{
+			ostringstream os1;
+			os1 << prefix.str() << "_" << k+1 << ".net";
+			pajekFile[k]->open(this->get_OutputName(os1.str()).c_str());
+			*pajekFile[k] << "*Vertices " << nSpe << endl;
+			for (sp1=0;sp1<nSpe;sp1++) *pajekFile[k] << sp1+1 << " " << this->_Species.at(sp1).get_Id() << endl;
+			*pajekFile[k] << ((k < 5) ? "*Edges" : "*Arcs") << endl;
+		}
+	}
+	if (table)
 	{
-		f1 << sp1+1 << " " << this->_Species.at(sp1).get_Id() << endl;
-		f2 << sp1+1 << " " << this->_Species.at(sp1).get_Id() << endl;
-		f3 << sp1+1 << " " << this->_Species.at(sp1).get_Id() << endl;
-		f4 << sp1+1 << " " << this->_Species.at(sp1).get_Id() << endl;
-		f5 << sp1+1 << " " << this->_Species.at(sp1).get_Id() << endl;
-		f6 << sp1+1 << " " << this->_Species.at(sp1).get_Id() << endl;
-		f7 << sp1+1 << " " << this->_Species.at(sp1).get_Id() << endl;
-		f8 << sp1+1 << " " << this->_Species.at(sp1).get_Id() << endl;
+		f9.open(this->get_OutputName(prefix.str() + ".dat").c_str());
+		f9 << "#SP1 SP2 W1 W2 W3 W4 W5 W6_12 W6_21 W7_12 W7_21 W8_12 W8_21" << endl;
 	}
-	f1 << "*Edges" << endl;	f2 << "*Edges" << endl;	f3 << "*Edges" << endl;	f4 << "*Edges" << endl; f5 << "*Edges" << endl; f6 << "*Arcs" << endl; f7 << "*Arcs" << endl; f8 << "*Arcs" << endl;
 // Methods to define the Edges of the coexistence network
+	//the totals of each species and the sites where it is alive (above the threshold) and present (nInd != 0) are
+	//computed once, as bitmaps of 64 sites per word, so each pair is an AND of the bitmaps plus a loop over the sites where both are present
+	nWords = (nSit + 63)/64;
+	limit.assign(nSit,0.0);
+	for (st=0;st<nSit;st++) limit[st] = this->_Abundance.total_Population[st]*Site::existence_threshold;
+	total.assign(nSpe,0);
+	alive.assign(nSpe,0);
+	aliveMap.assign(nSpe*nWords,0);
+	presentMap.assign(nSpe*nWords,0);
+	for (sp1=0;sp1<nSpe;sp1++)
+	{
+		n1 = this->_Abundance.get_IndividualsOfSpecies(sp1);
+		for (st=0;st<nSit;st++)
+		{
+			total[sp1]+=n1[st];
+			if (n1[st]>limit[st]) aliveMap[sp1*nWords + st/64] |= ((uint64_t)1 << (st%64));
+			if (n1[st]) presentMap[sp1*nWords + st/64] |= ((uint64_t)1 << (st%64));
+		}
+		for (w=0;w<nWords;w++) alive[sp1]+=__builtin_popcountll(aliveMap[sp1*nWords + w]);
+	}
 	for (sp1=0;sp1<nSpe-1;sp1++)
 	{
 		for (sp2=sp1+1;sp2<nSpe;sp2++)
 		{
-			sum1=0;	sum2=0;	sum3=0; sum4=0; sum6_1=0; sum6_2=0; sum8_1=0; sum8_2=0; total1=0; total2=0; nInd1=0; nInd2=0; Dasym_12=0; Dasym_21=0;
-			for (st=0;st<nSit;st++)
-			{
-				nInd1 = this->_Sites.at(st).get_NumberIndSpecies(sp1);
-				nInd2 = this->_Sites.at(st).get_NumberIndSpecies(sp2);
-				total1+=nInd1; total2+=nInd2;				
-			}
-			for (st=0;st<nSit;st++)
+			sum1=0;	sum4=0; sum8_1=0; sum8_2=0; both1=0; both2=0; Dasym_12=0; Dasym_21=0;
+			n1 = this->_Abundance.get_IndividualsOfSpecies(sp1);
+			n2 = this->_Abundance.get_IndividualsOfSpecies(sp2);
+			total1 = total[sp1]; total2 = total[sp2];
+			for (w=0;w<nWords;w++)
 			{
-				step_1 =this->_Sites.at(st).get_StepFunction(sp1);
-				step_2 =this->_Sites.at(st).get_StepFunction(sp2);
-				step_12 =this->_Sites.at(st).get_StepFunctionCoexistence(sp1,sp2);	
-				sum1+=step_12;//number of overlapping sites (sp1,sp2)	
-				sum2+=(total1 + total2)*step_12;
-				sum3+=(total1 * total2)*step_12;
-				sum6_1+=step_1;//number of sites where exists individuals of species 1 alive
-				sum6_2+=step_2;//number of sites where exists individuals of species 2 alive
-				sum4+=(this->_Sites.at(st).get_Weight(sp1,sp2));
-				DNMasym_12 = this->_Sites.at(st).get_ExpectedPercentIndividuals(sp2);//Prob. of overlapping 1 and 2, in a NULL Model (Ov[1,2] = DNMasym_12)
-				DNMasym_21 = this->_Sites.at(st).get_ExpectedPercentIndividuals(sp1);//Prob. of overlapping 2 and 1, in a NULL Model (Ov[2,1] = DNMasym_21)
-				sum8_1+=this->_Sites.at(st).get_NumberIndOverlapping(sp1,sp2);//number of individuals of sp1 in the site, if the site has overlapping of sp1 and sp2
-				sum8_2+=this->_Sites.at(st).get_NumberIndOverlapping(sp2,sp1);//number of individuals of sp2 in the site, if the site has overlapping of sp1 and sp2
-			}
-			sum5 = (float)this->get_XORIndividuals(sp1,sp2);
-			if (sum1) f1 << sp1+1 << " " << sp2+1 << " " << sum1 << endl;
-			if (sum2) f2 << sp1+1 << " " << sp2+1 << " " << sum2 << endl;
-			if (sum3) f3 << sp1+1 << " " << sp2+1 << " " << sum3 << endl;
-			if (sum4) f4 << sp1+1 << " " << sp2+1 << " " << sum4/nSit << endl;			
-			if (sum5) f5 << sp1+1 << " " << sp2+1 << " " << sum5/(total1+total2) << endl;
-			if (sum6_1) 
-			{
-				Dasym_12 = (float)sum1/sum6_1;//Assymetric Distance between species 1 and 2
-				if(Dasym_12) f6 << sp1+1 << " " << sp2+1 << " " << Dasym_12 << endl;//Assymetric Overlapping (1,2)
-			}
-			if (sum6_2) 
-			{
-				Dasym_21 = (float)sum1/sum6_2;//Assymetric Distance between species 2 and 1
-				if(Dasym_21) f6 << sp2+1 << " " << sp1+1 << " " << Dasym_21 << endl;//Assymetric Overlapping (2,1)
-			}
-			if (sum8_1)
-			{
-				f8 << sp1+1 << " " << sp2+1 << " " << ((float)sum8_1/(total1+total2)) << endl;//Assymetric Overlapping (1,2), considering the number of individuals
-			}
-			if (sum8_2)
-			{
-				f8 << sp2+1 << " " << sp1+1 << " " << ((float)sum8_2/(total1+total2)) << endl;//Assymetric Overlapping (2,1), considering the number of individuals
+				both = presentMap[sp1*nWords + w] & presentMap[sp2*nWords + w];
+				overlap = both & aliveMap[sp1*nWords + w] & aliveMap[sp2*nWords + w];
+				sum1+=__builtin_popcountll(overlap);//number of overlapping sites (sp1,sp2)
+				while (both)//the sites where both species are present, in order (the weights are summed as before)
+				{
+					st = w*64 + __builtin_ctzll(both);
+					sum4+=(this->_Sites[st].get_Weight(sp1,sp2));
+					both1+=n1[st]; both2+=n2[st];
+					if ((overlap >> (st%64)) & 1)
+					{
+						sum8_1+=n1[st];//number of individuals of sp1 in the site, if the site has overlapping of sp1 and sp2
+						sum8_2+=n2[st];//number of individuals of sp2 in the site, if the site has overlapping of sp1 and sp2
+					}
+					both &= both - 1;
+				}
 			}
-//			cerr << sp1+1 << ", " << sp2+1 << " ---> " << Dasym_12 << " > " << DNMasym_12 << endl;
-			if ( (Dasym_12)&&(Dasym_12 > DNMasym_12) )
+			sum2 = (total1 + total2)*sum1;
+			sum3 = (total1 * total2)*sum1;
+			sum6_1 = alive[sp1];//number of sites where exists individuals of species 1 alive
+			sum6_2 = alive[sp2];//number of sites where exists individuals of species 2 alive
+			DNMasym_12 = this->_Sites[nSit-1].get_ExpectedPercentIndividuals(sp2);//Prob. of overlapping 1 and 2, in a NULL Model (Ov[1,2] = DNMasym_12), in the last site
+			DNMasym_21 = this->_Sites[nSit-1].get_ExpectedPercentIndividuals(sp1);//Prob. of overlapping 2 and 1, in a NULL Model (Ov[2,1] = DNMasym_21), in the last site
+			sum5 = (float)((total1 - both1) + (total2 - both2));//individuals in the sites with only one of the species
+			if (sum6_1) Dasym_12 = (float)sum1/sum6_1;//Assymetric Distance between species 1 and 2
+			if (sum6_2) Dasym_21 = (float)sum1/sum6_2;//Assymetric Distance between species 2 and 1
+			if (pajek)
 			{
-				f7 << sp1+1 << " " << sp2+1 << " " << Dasym_12 << endl;
+				if (sum1) f1 << sp1+1 << " " << sp2+1 << " " << sum1 << endl;
+				if (sum2) f2 << sp1+1 << " " << sp2+1 << " " << sum2 << endl;
+				if (sum3) f3 << sp1+1 << " " << sp2+1 << " " << sum3 << endl;
+				if (sum4) f4 << sp1+1 << " " << sp2+1 << " " << sum4/nSit << endl;			
+				if (sum5) f5 << sp1+1 << " " << sp2+1 << " " << sum5/(total1+total2) << endl;
+				if (Dasym_12) f6 << sp1+1 << " " << sp2+1 << " " << Dasym_12 << endl;//Assymetric Overlapping (1,2)
+				if (Dasym_21) f6 << sp2+1 << " " << sp1+1 << " " << Dasym_21 << endl;//Assymetric Overlapping (2,1)
+				if (sum8_1)
+				{
+					f8 << sp1+1 << " " << sp2+1 << " " << ((float)sum8_1/(total1+total2)) << endl;//Assymetric Overlapping (1,2), considering the number of individuals
+				}
+				if (sum8_2)
+				{
+					f8 << sp2+1 << " " << sp1+1 << " " << ((float)sum8_2/(total1+total2)) << endl;//Assymetric Overlapping (2,1), considering the number of individuals
+				}
+//				cerr << sp1+1 << ", " << sp2+1 << " ---> " << Dasym_12 << " > " << DNMasym_12 << endl;
+				if ( (Dasym_12)&&(Dasym_12 > DNMasym_12) )
+				{
+					f7 << sp1+1 << " " << sp2+1 << " " << Dasym_12 << endl;
+				}
+//				cerr << sp2+1 << ", " << sp1+1 << " ---> " << Dasym_21 << " > " << DNMasym_21 << endl;
+				if ( (Dasym_21)&&(Dasym_21 > DNMasym_21) )
+				{
+					f7 << sp2+1 << " " << sp1+1 << " " << Dasym_21 << endl;
+				}
 			}
-//			cerr << sp2+1 << ", " << sp1+1 << " ---> " << Dasym_21 << " > " << DNMasym_21 << endl;
-			if ( (Dasym_21)&&(Dasym_21 > DNMasym_21) )
+			if (table)//the same weights of the Pajek files, 0 when the edge is not there
 			{
-				f7 << sp2+1 << " " << sp1+1 << " " << Dasym_21 << endl;
+				weight[0] = sum4/nSit;
+				weight[1] = (sum5) ? sum5/(total1+total2) : 0.0;
+				weight[2] = Dasym_12;
+				weight[3] = Dasym_21;
+				weight[4] = ( (Dasym_12)&&(Dasym_12 > DNMasym_12) ) ? Dasym_12 : 0.0;
+				weight[5] = ( (Dasym_21)&&(Dasym_21 > DNMasym_21) ) ? Dasym_21 : 0.0;
+				weight[6] = (sum8_1) ? (float)sum8_1/(total1+total2) : 0.0;
+				weight[7] = (sum8_2) ? (float)sum8_2/(total1+total2) : 0.0;
+				k = (sum1 > this->coexistence_Threshold)||(sum2 > this->coexistence_Threshold)||(sum3 > this->coexistence_Threshold);
+				for (w=0;(w<8)&&(!k);w++) k = (weight[w] > this->coexistence_Threshold);
+				if (k)
+				{
+					f9 << this->_Species.at(sp1).get_Id() << " " << this->_Species.at(sp2).get_Id() << " " << sum1 << " " << sum2 << " " << sum3;
+					for (w=0;w<8;w++) f9 << " " << weight[w];
+					f9 << endl;
+				}
 			}
 		}		
 	}	
-	f1.close(); f2.close();	f3.close(); f4.close(); f5.close(); f6.close(); f7.close();
+	f1.close(); f2.close();	f3.close(); f4.close(); f5.close(); f6.close(); f7.close(); f8.close(); f9.close();
 	
 	return;
 }
@@ -1548,6 +2847,7 @@ void Dynamic::CoexistenceNetworks(int realization, int space)
 void Dynamic::acummulate_IndividualsSpecies(int cont)
 {
 	int sum,sp,st,nSpe,nSit;
+	int *nInd;
 	
 	nSpe = (int)this->_Sites.at(0).get_NumberSpecies();
 	nSit = (int)this->_Sites.size();
@@ -1555,30 +2855,16 @@ void Dynamic::acummulate_IndividualsSpecies(int cont)
 	for (sp=0;sp<nSpe;sp++)
 	{
 		sum=0;
+		nInd = this->_Abundance.get_IndividualsOfSpecies(sp);
 		for (st=0;st<nSit;st++)
 		{
-			sum += this->_Sites.at(st).get_NumberIndSpecies(sp);
+			sum += nInd[st];
 		}
 		this->_Species.at(sp).set_IndividualsInTime(cont-1,this->mc_timestep,sum);
 	}	
 	return;
 }
 
-int Dynamic::get_XORIndividuals(int sp1, int sp2)
-{
-	int nInd1,nInd2,st,sum;
-
-	sum=0;
-	for (st=0;st<(int)this->_Sites.size();st++)
-	{
-		nInd1 = this->_Sites.at(st).get_NumberIndSpecies(sp1);
-		nInd2 = this->_Sites.at(st).get_NumberIndSpecies(sp2);
-		if ( ((nInd1)||(nInd2)) && ( !((nInd1)&&(nInd2)) ) ) sum+=nInd1+nInd2;//A XOR B --> ((A || B) && !(A && B))
-	}
-	
-	return(sum);
-}
-
 void Dynamic::print_TimeSeriesAtIteration(int real_I, int space_J)
 {
 	int sp;
@@ -1590,23 +2876,21 @@ void Dynamic::print_TimeSeriesAtIteration(int real_I, int space_J)
 
 void Dynamic::print_TimeSeriesOfSpecies(int real_I, int space_J)
 {
-	int t,sp,nSpecies,nreal_all_alive;
+	PROFILE_SCOPE(&this->profiler,PROFILE_PRINT);
+	int t,sp,nSpecies;
 	ofstream f2;
 	stringstream os2;
-	int lastAllAlive=0.0,nSpeAllAlive;
 	tStabilityAnalisys aux;
 
 	nSpecies = (int)this->_Species.size();
 	os2 << "AverIndInTime" << "_seed_" << this->seed << ".dat";
-	f2.open(os2.str().c_str());
+	f2.open(this->get_OutputName(os2.str()).c_str());
 	//defining the name of the output file
 	for (t=0;t<this->mc_timestep;t+=this->show_each)
 	{
 		f2 << t; 
-		nSpeAllAlive = 0;
 		for (sp=0;sp<nSpecies;sp++)
 		{
-			nreal_all_alive = this->_Species.at(sp).get_IterationWithIndInTime(t/show_each);
 			
 /***			
 			if (nreal_all_alive > 0) f2 << " " << (float)this->_Species.at(sp).get_IndividualsInTime(t/show_each)/(nreal_all_alive);
@@ -1616,19 +2900,60 @@ ALE: CAMBIO POR: ***/
 			f2 << " " << (float)this->_Species.at(sp).get_IndividualsInTime(t/show_each);  //ALE
 			
 /*ALE: fin cambio...*/			
-			if (nreal_all_alive > 0) nSpeAllAlive++;
 		}
 		f2 << endl;				
-		if (nSpeAllAlive == nSpecies) lastAllAlive = t+1;
 	}
 	f2.close();
 	aux.realization = space_J;
-	aux.last_IterAllAlive = lastAllAlive;
+	aux.last_IterAllAlive = this->get_LastIterationAllAlive();
 	this->list_StabilityAnalisys.push_back(aux);
 
 	return;
 }
 
+/*The last output iteration (+1) in which all the species had individuals (what print_StabilityAnalisys records)
+ * */
+int Dynamic::get_LastIterationAllAlive(void)
+{
+	int t,sp,nSpecies,nreal_all_alive,nSpeAllAlive;
+	int lastAllAlive=0;
+
+	nSpecies = (int)this->_Species.size();
+	for (t=0;t<this->mc_timestep;t+=this->show_each)
+	{
+		nSpeAllAlive = 0;
+		for (sp=0;sp<nSpecies;sp++)
+		{
+			nreal_all_alive = this->_Species.at(sp).get_IterationWithIndInTime(t/show_each);
+			if (nreal_all_alive > 0) nSpeAllAlive++;
+		}
+		if (nSpeAllAlive == nSpecies) lastAllAlive = t+1;
+	}
+
+	return(lastAllAlive);
+}
+
+/*Number of species of the food web (get_NumberSpecies returns the number of sites)
+ * */
+int Dynamic::get_NumberSpeciesFoodWeb(void)
+{
+	return(this->_Species.size());
+}
+
+/*Individuals (nOld+nNew) of the species 'sp' in all the sites
+ * */
+int Dynamic::get_TotalIndividuals(int sp)
+{
+	int st,sum;
+	int *nInd;
+
+	sum = 0;
+	nInd = this->_Abundance.get_IndividualsOfSpecies(sp);
+	for (st=0;st<(int)this->_Sites.size();st++) sum += nInd[st];
+
+	return(sum);
+}
+
 void Dynamic::print_FoodWeb(int real_I,int space_J)
 {
 	int sp,nSpecies;
@@ -1639,7 +2964,7 @@ void Dynamic::print_FoodWeb(int real_I,int space_J)
 
 	nSpecies = (int)this->_Species.size();
 	os1 << "FoodWeb" << "_seed_" << this->seed << "_" << ".net";
-	f1.open(os1.str().c_str());
+	f1.open(this->get_OutputName(os1.str()).c_str());
 	f1 << "*Vertices " << nSpecies << endl;
 	for (sp=0;sp<nSpecies;sp++)
 	{
@@ -1675,7 +3000,7 @@ void Dynamic::print_StabilityAnalisys(int real_I, int space_J)
 	int i;
 
 	os1 << "Realizations_vs_IterationWithAllAlive_space.dat";
-	f1.open(os1.str().c_str(),ios::app);
+	f1.open(this->get_OutputName(os1.str()).c_str(),ios::app);
 	for (i=0;i<(int)this->list_StabilityAnalisys.size();i++)
 	{
 		f1 << list_StabilityAnalisys.at(i).realization << " " << list_StabilityAnalisys.at(i).last_IterAllAlive << endl;
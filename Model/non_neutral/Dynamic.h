@@ -28,8 +28,66 @@
 #define REALIZATIONS 1
 #define CHANGES_IN_PARAMETERS 1 
 
+//files of the coexistence networks (see CoexistenceNetworks), they can be combined with |
+//- COEXISTENCE_TABLE - one file per snapshot, overlapping_NNNNN_seed_S_real_R_changes_C.dat, with one line per pair of species:
+//                      ID1 ID2 W1 W2 W3 W4 W5 W6_12 W6_21 W7_12 W7_21 W8_12 W8_21, the weights of the Pajek files 1..8
+//                      (6, 7 and 8 in both directions), 0 when the edge is not in the network
+//- COEXISTENCE_PAJEK - the eight Pajek files per snapshot, overlapping_NNNNN_seed_S_real_R_changes_C_K.net
+#define COEXISTENCE_TABLE 1
+#define COEXISTENCE_PAJEK 2
+
+#ifndef COEXISTENCE_LAYOUT
+#define COEXISTENCE_LAYOUT COEXISTENCE_TABLE
+#endif
+
+//engines of the iteration of each site (see set_Engine):
+//- ENGINE_EXACT   - MonteCarlo_Site, the events of the individuals one by one
+//- ENGINE_TAULEAP - TauLeap_Site, the events of the iteration sampled in bulk with the rates of its begining
+//- ENGINE_GILLESPIE - Gillespie_Step, the events of all the sites in continuous time (next-reaction method), with the
+//                   migration as one more event instead of Migration
+//- ENGINE_MEANFIELD - MeanField, the deterministic mean field of the same rates, integrated with an adaptive Runge-Kutta
+#define ENGINE_EXACT 1
+#define ENGINE_TAULEAP 2
+#define ENGINE_GILLESPIE 3
+#define ENGINE_MEANFIELD 4
+
+#ifndef MC_ENGINE
+#define MC_ENGINE ENGINE_EXACT
+#endif
+
+//modes of Migration (see set_Migration):
+//- MIGRATION_SEQUENTIAL - the sites and species one by one in a random order, each migration sees the ones before it
+//- MIGRATION_TWOPHASE   - Migration_TwoPhase, the flows of all the sites computed at the same time from the individuals
+//                         before the migration, and then the capacity of each target shared by the random order of
+//                         the sites (the same results with any number of threads)
+#define MIGRATION_SEQUENTIAL 1
+#define MIGRATION_TWOPHASE 2
+
+#ifndef MC_MIGRATION
+#define MC_MIGRATION MIGRATION_SEQUENTIAL
+#endif
+
+//tolerances of the steps of MeanField (relative, and absolute in individuals) and the smallest step
+#ifndef MEANFIELD_RTOL
+#define MEANFIELD_RTOL 1e-3
+#endif
+#ifndef MEANFIELD_ATOL
+#define MEANFIELD_ATOL 0.1
+#endif
+#define MEANFIELD_HMIN 1e-6
+
+#ifndef COEXISTENCE_THRESHOLD
+#define COEXISTENCE_THRESHOLD 0.0
+#endif
+
 #include "Site.h"
 #include "Species.h"
+#include "AllocStats.h"
+#include "OutputSink.h"
+#include "FlowRecorder.h"
+#include "Profiler.h"
+#include "NetworkFile.h"
+#include "EventQueue.h"
 #include <math.h>
 
 typedef struct sStabilityAnalisys
@@ -38,32 +96,97 @@ typedef struct sStabilityAnalisys
 	int last_IterAllAlive;
 }tStabilityAnalisys;
 
+typedef struct sSOC_Densities//sums of densities around a species in a site, shared by the SOC_* rates
+{
+	float bx;//sum over the preys of d_prey*(1-d_predOfprey)
+	float dx;//sum over the preys of d_predOfprey*(1-d_prey)
+	float d_prey;//sum over the preys of d_prey
+	float d_predOfprey;//sum over the preys of d_predOfprey
+	float dy;//sum over the predators of d_pred
+}tSOC_Densities;
+
 class Dynamic
 {
 	private:
 		int mc_timestep;
 		vector<tStabilityAnalisys> list_StabilityAnalisys;
 		vector<int> sitesOrdered;
+		Random rng;//stream for the decisions that are not of one site (the order of the sites)
 		vector<Site> _Sites;
+		Abundance _Abundance;//the individuals of all the species in all the sites (used by the _Sites)
 		vector<Species> _Species;	
+		vector<int> preys_Offset, preys_Index;//compressed (CSR) list of preys: the preys of 'sp' are preys_Index[preys_Offset[sp]..preys_Offset[sp+1]-1]
+		vector<int> predators_Offset, predators_Index;//the same for the predators
+		vector<int> pref_Offset, pref_Index, pref_Sign;//the preys (+1) and the predators (-1) of each species in one list, for the Pref (calc_PrefSite)
+		vector<int> neigh_Offset, neigh_Index, neigh_Weight;//the landscape in CSR: the neighbors of 'st' (0..N-1) and their weights are neigh_Index[neigh_Offset[st]..neigh_Offset[st+1]-1]
+		vector<int> neigh_Source;//the site of each edge of neigh_Index
+		vector<int> neigh_InOffset, neigh_InEdge;//the edges that arrive at 'st' are neigh_InEdge[neigh_InOffset[st]..neigh_InOffset[st+1]-1] (ascending sources)
+		vector<int> migration_Sum;//the sum of the positive [ Pref(target)-Pref(site) ]*weight of each site and species, as the Abundance matrix (calc_MigrationSums)
+		int migration;//MIGRATION_SEQUENTIAL or MIGRATION_TWOPHASE
+		vector<int> migration_Flow;//the individuals of each species through each edge, sp*E + edge (MIGRATION_TWOPHASE)
+		vector<int> migration_Rank;//the position of each site in sitesOrdered
+		vector<int> migration_Order;//the edges of neigh_InEdge of each target, by the rank of their sources
+		void Migration_TwoPhase(void);
+		void request_Migrations(int st);
+		void accept_Migrations(int tg);
 		int niter, tm, tcn, seed, show_each,save_each;
 		string name_FWNF, name_SNNF;
+		string dir_Output;//directory of the output files ("" - the current directory)
+		OutputSink _Output;//buffers of the time series of print_File
+		FlowRecorder _Flows;//the migrations through each edge, written every SAVE-EACH iterations
+		Profiler profiler;//the time of the parts of the Monte Carlo and its events (only with MC_PROFILE)
+		void print_Profile(int realization, int changes);
+		int write_Files;//0 - the Monte Carlo doesn't write output files
+		ostream *out_Log;//where the messages of the Monte Carlo are written (cerr by default)
+		int coexistence_Layout;//COEXISTENCE_TABLE and/or COEXISTENCE_PAJEK
+		float coexistence_Threshold;//the pairs with all the weights <= coexistence_Threshold are not in the table
+		int write_Checkpoints;//1 - a checkpoint is written every SAVE-EACH iterations (if write_Files)
+		int first_Timestep;//the first iteration of the next MonteCarlo (0, or the one after a checkpoint)
+		int engine;//ENGINE_EXACT, ENGINE_TAULEAP, ENGINE_GILLESPIE or ENGINE_MEANFIELD
+		vector<int> tau_Deaths, tau_Births;//events of the iteration of each site and species (ENGINE_TAULEAP)
+		EventQueue gillespie_Queue;//the time of the next event of each site (ENGINE_GILLESPIE)
+		vector<double> gillespie_Rates;//the rates of each site and species: natural death, feeding (or birth) and migration
+		vector<double> gillespie_SiteRate;//the sum of the rates of each site
+		void start_SiteStep(int st);
+		void TauLeap_Site(int st);
+		void Gillespie_Step(void);
+		double calc_GillespieRates(int st);
+		int Gillespie_Event(int st);
+		vector<double> meanField_X;//the individuals of each site and species (ENGINE_MEANFIELD), as the Abundance matrix
+		vector<double> meanField_K;//the stages of the Runge-Kutta
+		vector<double> meanField_Work;//the rates of calc_MeanFieldRHS
+		void MeanField(int realization, int changes);
+		int integrate_MeanField(double *h);
+		void calc_MeanFieldRHS(const double *x, double *dxdt);
 		void init_Sites(void);
 		void init_Species(void);
+		void init_TrophicIndex(void);
+		void init_NeighborIndex(void);
 		void print_TimeSeriesOfSpecies(int,int);
 		void print_SOC_SpaceOfParameters(int,int);
+		string get_SOCName(int sp, int realization);
+		void fill_CheckpointHeader(tCheckpointHeader *header, int realization, int changes);
 		void print_Variables(int);
 		int get_NumberSpecies(void);	
-		int get_XORIndividuals(int sp1, int sp2);
 		int get_NumberIndPreys(int,int);
 		int get_NumberIndPredators(int,int);
 		void acummulate_IndividualsSpecies(int);
 		void SOC(int,int);
+		void update_Rates(int sp, int st);
+		int get_RateCC(int sp, int st);
+		vector<float> soc_Work;//the densities of SOC_Site, a slice of 7*nSpecies for each site
+		void SOC_Site(int st);
+		void update_SpeciesData(void);
+		void calc_SOC_Densities(int,int,tSOC_Densities*);
 		float SOC_DP(int,int);
+		float SOC_DP(int,int,tSOC_Densities*);
 		float SOC_NDP(int,int);
+		float SOC_NDP(int,int,tSOC_Densities*);
 		float SOC_BP(int,int);
+		float SOC_BP(int,int,tSOC_Densities*);
 		float SOC_MP(int,int);
 		int SOC_CC(int,int);
+		int SOC_CC(int,int,tSOC_Densities*);
 		float get_SOC_AvrDeathProb(int, int);
 		float get_SOC_AvrNatDeathProb(int, int);
 		float get_SOC_AvrBirthProb(int, int);
@@ -76,6 +199,8 @@ class Dynamic
 	public:
 		
 		string sufix;
+		static int default_Engine;//the engine of the new Dynamics (MC_ENGINE, or the one of the command line)
+		static int default_Migration;//the mode of Migration of the new Dynamics (MC_MIGRATION, or the one of the command line)
 		void SpaceOfParameters(int, vector<int>*, int, int);
 		void print_File(int,int);
 		void print_StabilityAnalisys(int,int);
@@ -83,14 +208,38 @@ class Dynamic
 		void print_TimeSeriesAtIteration(int,int);
 		void CoexistenceNetworks(int,int);
 		void MonteCarlo(int,int);
+		void MonteCarlo_Site(int,int);
 		void DynamicPrey(int,int,int);
 		void DynamicPredator(void);
 		void Migration(int);
 		void init_Components(int);
+		void load_Structure(void);
+		void copy_Structure(Dynamic *from);
+		void set_OutputDirectory(string dir);
+		void set_Log(ostream *log);
+		string get_OutputName(string name);
+		void set_WriteFiles(int write);
+		void set_OutputLayout(int layout);//OUTPUT_PER_SPECIES, OUTPUT_COMBINED or OUTPUT_BINARY
+		void set_CoexistenceLayout(int layout, float threshold);
+		void set_Checkpoints(int write);
+		void set_Engine(int engine);
+		static int get_Engine(string name);
+		static string get_EngineName(int engine);
+		void set_Migration(int migration);
+		static int get_Migration(string name);
+		string get_CheckpointName(void);
+		void save_Checkpoint(int realization, int changes);
+		int load_Checkpoint(int realization, int changes);
+		void set_ParameterSpecies(int p, int sp, float value);
+		int get_LastIterationAllAlive(void);
+		int get_TotalIndividuals(int sp);
+		int get_NumberSpeciesFoodWeb(void);
 		void init_Individuals(int st, int sp, int cont);
 		void reorder_Sites(void);
 		void set_Pref(void);
-		int calc_SumN(int,int);
+		void calc_PrefSite(int st);
+		void calc_MigrationSums(void);
+		int ver_MigrationVacancy(int st, int sp);
 		Dynamic(int,int,int,int,char*,char*,int,int);
 		~Dynamic();
 };
@@ -0,0 +1,85 @@
+#include "EngineCheck.h"
+#include <math.h>
+
+EngineCheck::EngineCheck(int niter, int tm, int tcn, int seed, char *fwnf, char *snnf, int show_each, int save_each, int nSeeds, int engine) : Driver(niter,tm,tcn,seed,fwnf,snnf,show_each,save_each)
+{
+	this->nSeeds = nSeeds;
+	this->engine = engine;
+}
+
+EngineCheck::~EngineCheck()
+{
+	this->results.clear();
+}
+
+/*To run the seeds with both engines and to write the comparison. It returns the number of values with |T| > 3
+ * */
+int EngineCheck::run(void)
+{
+	int k,i,n,nValues,bad;
+	double mean[2],var[2],se,t;
+	ofstream f1;
+	ostringstream os1;
+
+	if (this->nSeeds < 2)
+	{
+		cerr << "THE CHECK NEEDS AT LEAST 2 SEEDS!" << endl;
+		exit(1);
+	}
+	this->load_Structure();
+	nValues = this->structure->get_NumberSpeciesFoodWeb() + 1;
+	this->results.assign(2*this->nSeeds,vector<double>(nValues,0.0));
+	cerr << "RUNNING " << this->nSeeds << " SEEDS WITH THE ENGINES exact AND " << Dynamic::get_EngineName(this->engine) << endl;
+#pragma omp parallel for schedule(dynamic)
+	for (k=0;k<2*this->nSeeds;k++)//each run is independent of the others
+	{
+		this->run_Seed(k/2,(k%2) ? this->engine : ENGINE_EXACT);
+	}
+	os1 << "EngineCheck_" << Dynamic::get_EngineName(this->engine) << "_seed_" << this->seed << ".dat";
+	f1.open(os1.str().c_str());
+	f1 << "#NAME MEAN_EXACT SD_EXACT MEAN_ENGINE SD_ENGINE T" << endl;
+	bad = 0;
+	n = this->nSeeds;
+	for (i=0;i<nValues;i++)
+	{
+		for (k=0;k<2;k++)
+		{
+			mean[k] = 0.0;
+			var[k] = 0.0;
+		}
+		for (k=0;k<2*n;k++) mean[k%2] += this->results.at(k).at(i)/n;
+		for (k=0;k<2*n;k++) var[k%2] += pow(this->results.at(k).at(i) - mean[k%2],2)/(n-1);
+		se = sqrt(var[0]/n + var[1]/n);
+		if (se > 0) t = (mean[1] - mean[0])/se;
+		else t = (mean[1] == mean[0]) ? 0.0 : HUGE_VAL;
+		if (i == 0) f1 << "LAST_ALL_ALIVE";
+		else f1 << "IND_SP" << i;
+		f1 << " " << mean[0] << " " << sqrt(var[0]) << " " << mean[1] << " " << sqrt(var[1]) << " " << t << endl;
+		if (fabs(t) > 3)
+		{
+			if (i == 0) cerr << "LAST_ALL_ALIVE";
+			else cerr << "IND_SP" << i;
+			cerr << ": THE ENGINES DIFFER (T = " << t << ")" << endl;
+			bad++;
+		}
+	}
+	f1.close();
+	cerr << os1.str() << ": " << bad << " OF " << nValues << " VALUES WITH |T| > 3" << endl;
+
+	return(bad);
+}
+
+/*To run the seed SEED+k with 'engine' and to keep its results
+ * */
+void EngineCheck::run_Seed(int k, int engine)
+{
+	vector<int> summary;
+	Dynamic *d1;
+
+	d1 = this->new_Run(this->seed+k);
+	d1->set_Engine(engine);
+	this->run_Summary(d1,&summary);
+	this->results.at(2*k + (engine != ENGINE_EXACT)).assign(summary.begin(),summary.end());
+
+	return;
+}
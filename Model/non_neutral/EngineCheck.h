@@ -0,0 +1,52 @@
+//Class EngineCheck, that compares an engine of the Monte Carlo (ENGINE_TAULEAP, Dynamic::TauLeap_Site,
+//ENGINE_GILLESPIE, Dynamic::Gillespie_Step, or ENGINE_MEANFIELD, Dynamic::MeanField) with the exact one
+//(ENGINE_EXACT) by the statistics of an ensemble of runs:
+//- the food web (FWNF) and the landscape (SNNF) are read only once (see Driver.h)
+//- NSEEDS seeds (SEED, SEED+1, ...) are run with both engines, at the same time by a pool of threads
+//  (OpenMP, OMP_NUM_THREADS). The runs don't write any output file.
+//- EngineCheck_<ENGINE>_seed_<SEED>.dat (ENGINE is tauleap, gillespie or meanfield) has one line for each species (and one
+//  for LAST_ALL_ALIVE): NAME MEAN_EXACT SD_EXACT MEAN_ENGINE SD_ENGINE T
+//  where T is the t of Welch of the difference of the means. |T| > 3 is reported in stderr.
+
+/***************************************************************************
+ *            EngineCheck.h
+ *
+ *  Copyright  2009  User Charles Novaes de Santana & Alejandro Rozenfeld
+ *  Email charles.santana@gmail.com / alex@ifisc.uib-csic.es
+ ****************************************************************************/
+
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _ENGINECHECK_H_
+#define _ENGINECHECK_H_
+
+#include "Driver.h"
+
+class EngineCheck : public Driver
+{
+	private:
+		int nSeeds;
+		int engine;//the engine compared with ENGINE_EXACT
+		vector< vector<double> > results;//for each run (seed and engine): LAST_ALL_ALIVE INDIVIDUALS_SP1 ... INDIVIDUALS_SPn (Driver::run_Summary)
+		void run_Seed(int k, int engine);
+	public:
+		int run(void);
+		EngineCheck(int niter, int tm, int tcn, int seed, char *fwnf, char *snnf, int show_each, int save_each, int nSeeds, int engine);
+		~EngineCheck();
+};
+
+#endif
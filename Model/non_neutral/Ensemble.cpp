@@ -0,0 +1,105 @@
+#include "Ensemble.h"
+#include <sys/stat.h>
+#include <sys/types.h>
+
+Ensemble::Ensemble(int niter, int tm, int tcn, int seed, char *fwnf, char *snnf, int show_each, int save_each) : Driver(niter,tm,tcn,seed,fwnf,snnf,show_each,save_each)
+{
+	this->nSeeds = 1;
+	this->seed_Step = 1;
+	this->use_Directories = 0;
+	this->resume = 0;
+}
+
+/*To run 'nSeeds' seeds: SEED, SEED+seed_Step, ..., each one in the directory seed_<seed>
+ * */
+void Ensemble::set_Seeds(int nSeeds, int seed_Step)
+{
+	this->nSeeds = nSeeds;
+	this->seed_Step = seed_Step;
+	this->use_Directories = 1;
+	return;
+}
+
+/*To continue each seed from its checkpoint (the seeds without checkpoint run from the begining)
+ * */
+void Ensemble::set_Resume(int resume)
+{
+	this->resume = resume;
+	return;
+}
+
+void Ensemble::run(void)
+{
+	int k;
+
+	this->load_Structure();
+	if (!this->use_Directories)
+	{
+		this->run_Seed(this->seed,"",&cerr);
+		return;
+	}
+	cerr << "RUNNING " << this->nSeeds << " SEEDS FROM " << this->seed << " (STEP " << this->seed_Step << ")" << endl;
+#pragma omp parallel for schedule(dynamic)
+	for (k=0;k<this->nSeeds;k++)//each seed is independent of the others
+	{
+		int s;
+		ostringstream dir;
+		ofstream flog;
+
+		s = this->seed + k*this->seed_Step;
+		dir << "seed_" << s;
+		mkdir(dir.str().c_str(),0755);
+		flog.open((dir.str() + "/erro").c_str(),(this->resume) ? ofstream::app : ofstream::trunc);//the messages of the run that was stopped are kept
+#pragma omp critical
+		cerr << "SEED " << s << " -> " << dir.str() << "/" << endl;
+		this->run_Seed(s,dir.str(),&flog);
+		flog.close();
+	}
+
+	return;
+}
+
+/*The same runs of the program for one seed: CHANGES_IN_PARAMETERS x REALIZATIONS
+ * */
+void Ensemble::run_Seed(int seed, string dir, ostream *log)
+{
+	int i,j,found;
+	string name;
+	tCheckpointHeader header;
+
+	found = 0;
+	for (j=0;j<CHANGES_IN_PARAMETERS;j++) // changes in the parameters
+	{	
+		Dynamic *d1 = this->new_Run(seed);
+		d1->set_OutputDirectory(dir);
+		d1->set_Log(log);
+		if (j == 0)
+		{
+			name = d1->get_CheckpointName();
+			if (this->resume) found = Checkpoint::read_Header(name,&header);
+			if (found) *log << "CONTINUING FROM THE CHECKPOINT " << name << " (CHANGES " << header.changes << ", REALIZATION " << header.realization << ", ITERATION " << header.timestep << ")" << endl;
+		}
+		if ((found)&&(j < header.changes))//this change of the parameters was finished before the checkpoint
+		{
+			delete(d1);
+			continue;
+		}
+		for(i=1;i<=REALIZATIONS;i++)
+		{
+			if ((found)&&(j == header.changes)&&(i < header.realization)) continue;//finished before the checkpoint
+			*log << "Run the Monte Carlo (" << i << ")!" << endl;
+			d1->init_Components(i-1);
+			if ((found)&&(j == header.changes)&&(i == header.realization)) d1->load_Checkpoint(i,j);
+			d1->MonteCarlo(i,j);
+		}
+		if (j==0) d1->sufix.assign("par0_var0_Null");
+		*log << "PRINTING THE REALIZATION " << i-1 << " OF THE SPACE OF PARAMETERS " << j << endl;
+		d1->print_TimeSeriesAtIteration(i-1,j);
+		d1->print_FoodWeb(i-1,j);
+		d1->print_StabilityAnalisys(i-1,j);
+		delete(d1);
+	}
+	remove(name.c_str());//the seed is finished, there is nothing to continue
+
+	return;
+}
@@ -0,0 +1,56 @@
+//Class Ensemble, that runs the simulation for a list of seeds (SEED, SEED+STEP, SEED+2*STEP, ...) in
+//only one process:
+//- the food web (FWNF) and the landscape (SNNF) are read only once (see Driver.h)
+//- the seeds are run at the same time by a pool of threads (OpenMP, OMP_NUM_THREADS)
+//- each seed writes its output files and its messages ('erro') in its own directory, seed_<SEED>
+//
+//With only one seed and no directories (the default of the command line) the outputs are written in the
+//current directory and the messages go to stderr, just like a single run of the program.
+//
+//Each seed writes a checkpoint every SAVE-EACH iterations (checkpoint_seed_<SEED>.chk, see Dynamic::save_Checkpoint),
+//removed when the seed finishes. With set_Resume the seeds that have a checkpoint continue from it.
+
+/***************************************************************************
+ *            Ensemble.h
+ *
+ *  Copyright  2009  User Charles Novaes de Santana & Alejandro Rozenfeld
+ *  Email charles.santana@gmail.com / alex@ifisc.uib-csic.es
+ ****************************************************************************/
+
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _ENSEMBLE_H_
+#define _ENSEMBLE_H_
+
+#include "Driver.h"
+
+class Ensemble : public Driver
+{
+	private:
+		int nSeeds, seed_Step;
+		int use_Directories;//1 - each seed in its own directory
+		int resume;//1 - to continue the seeds from their checkpoints
+		void run_Seed(int seed, string dir, ostream *log);
+	public:
+		void set_Seeds(int nSeeds, int seed_Step);
+		void set_Resume(int resume);
+		void run(void);
+		Ensemble(int niter, int tm, int tcn, int seed, char *fwnf, char *snnf, int show_each, int save_each);
+		~Ensemble(){};
+};
+
+#endif
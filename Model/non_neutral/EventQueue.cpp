@@ -0,0 +1,76 @@
+#include "EventQueue.h"
+#include <math.h>
+
+/*n events, all of them with the time HUGE_VAL
+ * */
+void EventQueue::init(int n)
+{
+	int i;
+
+	this->time.assign(n,HUGE_VAL);
+	this->heap.resize(n);
+	this->position.resize(n);
+	for (i=0;i<n;i++)
+	{
+		this->heap[i] = i;
+		this->position[i] = i;
+	}
+
+	return;
+}
+
+void EventQueue::set_Time(int event, double t)
+{
+	double old;
+
+	old = this->time[event];
+	this->time[event] = t;
+	if (t < old) this->move_Up(this->position[event]);
+	else if (t > old) this->move_Down(this->position[event]);
+
+	return;
+}
+
+void EventQueue::swap_Nodes(int i, int j)
+{
+	int aux;
+
+	aux = this->heap[i];
+	this->heap[i] = this->heap[j];
+	this->heap[j] = aux;
+	this->position[this->heap[i]] = i;
+	this->position[this->heap[j]] = j;
+
+	return;
+}
+
+void EventQueue::move_Up(int i)
+{
+	int parent;
+
+	while (i > 0)
+	{
+		parent = (i - 1)/2;
+		if (this->time[this->heap[parent]] <= this->time[this->heap[i]]) break;
+		this->swap_Nodes(i,parent);
+		i = parent;
+	}
+
+	return;
+}
+
+void EventQueue::move_Down(int i)
+{
+	int child,n;
+
+	n = (int)this->heap.size();
+	while ((child = 2*i + 1) < n)
+	{
+		if ((child + 1 < n) && (this->time[this->heap[child+1]] < this->time[this->heap[child]])) child++;
+		if (this->time[this->heap[i]] <= this->time[this->heap[child]]) break;
+		this->swap_Nodes(i,child);
+		i = child;
+	}
+
+	return;
+}
@@ -0,0 +1,56 @@
+//Class EventQueue, an indexed priority queue (binary heap) of the next times of N events, for the
+//next-reaction method of Gibson & Bruck (Dynamic::Gillespie_Step): each event 0..N-1 has its next time, the
+//first one is get_Top (O(1)) and the time of any event can be changed with set_Time (O(log N)), because
+//the position of each event in the heap is kept. The events that never happen have the time HUGE_VAL.
+
+/***************************************************************************
+ *            EventQueue.h
+ *
+ *  Copyright  2009  User Charles Novaes de Santana & Alejandro Rozenfeld
+ *  Email charles.santana@gmail.com / alex@ifisc.uib-csic.es
+ ****************************************************************************/
+
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _EVENTQUEUE_H_
+#define _EVENTQUEUE_H_
+
+#include <vector>
+
+using namespace::std;
+
+class EventQueue
+{
+	private:
+		vector<double> time;//the time of each event
+		vector<int> heap;//the events, the first one at heap[0]
+		vector<int> position;//the position of each event in the heap
+		void swap_Nodes(int i, int j);
+		void move_Up(int i);
+		void move_Down(int i);
+	public:
+		void init(int n);
+		void set_Time(int event, double t);
+		double get_Time(int event) { return(this->time[event]); }
+		int get_Top(void) { return(this->heap[0]); }
+		double get_TopTime(void) { return(this->time[this->heap[0]]); }
+		int get_Size(void) { return((int)this->heap.size()); }
+		EventQueue(){};
+		~EventQueue(){};
+};
+
+#endif
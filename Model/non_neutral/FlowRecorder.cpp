@@ -0,0 +1,242 @@
+#include "FlowRecorder.h"
+#include <iostream>
+#include <sstream>
+#include <stdio.h>
+#include <stdint.h>
+
+FlowRecorder::FlowRecorder()
+{
+	this->layout = FLOWS_LAYOUT;
+	this->seed = 0;
+	this->realization = -1;
+	this->changes = 0;
+	this->nEdges = 0;
+	this->nSpecies = 0;
+	this->block_First = 0;
+	this->busy = 0;
+	this->stop = 0;
+	this->running = 0;
+	pthread_mutex_init(&this->lock,NULL);
+	pthread_cond_init(&this->has_Work,NULL);
+	pthread_cond_init(&this->is_Idle,NULL);
+}
+
+FlowRecorder::~FlowRecorder()
+{
+	this->stop_Writer();
+	pthread_cond_destroy(&this->is_Idle);
+	pthread_cond_destroy(&this->has_Work);
+	pthread_mutex_destroy(&this->lock);
+}
+
+/*The edges of the landscape ('source' -> 'target', as Dynamic::neigh_Source and Dynamic::neigh_Index). The current
+ * block starts empty
+ * */
+void FlowRecorder::init(vector<int> &source, vector<int> &target, int nSpecies)
+{
+	this->source = source;
+	this->target = target;
+	this->nEdges = (int)target.size();
+	this->nSpecies = nSpecies;
+	this->flows.assign(this->nEdges*nSpecies,0);
+
+	return;
+}
+
+int FlowRecorder::is_Open(int seed, int realization, int changes)
+{
+	return((this->realization != -1) && (this->seed == seed) && (this->realization == realization) && (this->changes == changes));
+}
+
+/*To finish the previous file and to start the file of (seed, realization, changes) in the directory 'dir' ("" or
+ * ending with '/'). The first block starts at the iteration 'first'
+ * */
+void FlowRecorder::open(string dir, int seed, int realization, int changes, int first)
+{
+	ostringstream os1;
+	ofstream f1;
+
+	this->stop_Writer();
+	this->seed = seed;
+	this->realization = realization;
+	this->changes = changes;
+	this->block_First = first;
+	this->flows.assign(this->flows.size(),0);
+	if (this->layout == FLOWS_NONE)
+	{
+		this->name.clear();
+		return;
+	}
+	os1 << dir << "migration_flows_seed_" << seed << "_real_" << realization << "_changes_" << changes << ((this->layout == FLOWS_BINARY) ? ".flw" : ".csv");
+	this->name = os1.str();
+	f1.open(this->name.c_str(),ofstream::binary | ofstream::trunc);
+	if (this->layout == FLOWS_CSV) f1 << "first,last,source,target,species,individuals" << endl;
+	f1.close();
+	this->start_Writer();
+
+	return;
+}
+
+/*To finish the block of the iterations block_First..last: the flows that are not 0 are given to the writer
+ * */
+void FlowRecorder::end_Block(int last)
+{
+	int sp,e,count;
+	int32_t rec[4];
+	string buf;
+	char line[96];
+
+	if (last < this->block_First) return;
+	count = 0;
+	for (sp=0;sp<this->nSpecies;sp++)
+	{
+		for (e=0;e<this->nEdges;e++)
+		{
+			if (this->flows[sp*this->nEdges + e] == 0) continue;
+			if (this->layout == FLOWS_CSV)
+			{
+				sprintf(line,"%d,%d,%d,%d,%d,%d\n",this->block_First,last,this->source[e]+1,this->target[e]+1,sp+1,this->flows[sp*this->nEdges + e]);
+				buf.append(line);
+			}
+			else
+			{
+				rec[0] = this->source[e]+1;
+				rec[1] = this->target[e]+1;
+				rec[2] = sp+1;
+				rec[3] = this->flows[sp*this->nEdges + e];
+				buf.append((const char*)rec,sizeof(rec));
+			}
+			this->flows[sp*this->nEdges + e] = 0;
+			count++;
+		}
+	}
+	if ((this->layout == FLOWS_BINARY) && (count))
+	{
+		rec[0] = this->block_First;
+		rec[1] = last;
+		rec[2] = count;
+		buf.insert(0,(const char*)rec,3*sizeof(int32_t));
+	}
+	this->block_First = last + 1;
+	if ((!count) || (!this->running)) return;
+	pthread_mutex_lock(&this->lock);
+	this->pending.push_back(buf);
+	pthread_cond_signal(&this->has_Work);
+	pthread_mutex_unlock(&this->lock);
+
+	return;
+}
+
+/*To wait until the writer has written all the blocks
+ * */
+void FlowRecorder::flush(void)
+{
+	if (!this->running) return;
+	pthread_mutex_lock(&this->lock);
+	while ((!this->pending.empty()) || (this->busy)) pthread_cond_wait(&this->is_Idle,&this->lock);
+	pthread_mutex_unlock(&this->lock);
+
+	return;
+}
+
+/*To finish the last block (up to the iteration 'last') and the file
+ * */
+void FlowRecorder::close(int last)
+{
+	if (this->realization == -1) return;
+	this->end_Block(last);
+	this->stop_Writer();
+	this->realization = -1;
+
+	return;
+}
+
+void FlowRecorder::start_Writer(void)
+{
+	if ((this->running) || (this->name.empty())) return;
+	this->stop = 0;
+	this->busy = 0;
+	if (pthread_create(&this->writer,NULL,FlowRecorder::run_Writer,this) == 0) this->running = 1;
+	else cerr << "IT WAS NOT POSSIBLE TO START THE WRITER OF " << this->name << endl;
+
+	return;
+}
+
+/*The writer writes all the blocks that are pending before it stops
+ * */
+void FlowRecorder::stop_Writer(void)
+{
+	if (!this->running) return;
+	pthread_mutex_lock(&this->lock);
+	this->stop = 1;
+	pthread_cond_signal(&this->has_Work);
+	pthread_mutex_unlock(&this->lock);
+	pthread_join(this->writer,NULL);
+	this->running = 0;
+
+	return;
+}
+
+/*The background writer: it appends the pending blocks to the file, in order
+ * */
+void* FlowRecorder::run_Writer(void *recorder)
+{
+	FlowRecorder *r;
+	ofstream f1;
+	string buf;
+
+	r = (FlowRecorder*)recorder;
+	f1.open(r->name.c_str(),ofstream::binary | ofstream::app);
+	pthread_mutex_lock(&r->lock);
+	while (1)
+	{
+		while ((r->pending.empty()) && (!r->stop)) pthread_cond_wait(&r->has_Work,&r->lock);
+		if (r->pending.empty()) break;//stop, and nothing else to write
+		buf.swap(r->pending.front());
+		r->pending.pop_front();
+		r->busy = 1;
+		pthread_mutex_unlock(&r->lock);
+		f1.write(buf.data(),buf.size());
+		f1.flush();
+		buf.clear();
+		pthread_mutex_lock(&r->lock);
+		r->busy = 0;
+		if (r->pending.empty()) pthread_cond_broadcast(&r->is_Idle);
+	}
+	pthread_cond_broadcast(&r->is_Idle);
+	pthread_mutex_unlock(&r->lock);
+	f1.close();
+
+	return(NULL);
+}
+
+/*To write the pending blocks and to save the file that is open, with its size. The current block must be empty
+ * (the checkpoints are written at the end of a block)
+ * */
+void FlowRecorder::save_State(Checkpoint *cp)
+{
+	this->flush();
+	cp->write_Int(this->seed);
+	cp->write_Int(this->realization);
+	cp->write_Int(this->changes);
+	cp->write_Int(this->block_First);
+	cp->write_FileSize(this->name);
+
+	return;
+}
+
+/*To continue the file saved by save_State, without what was written in it after the checkpoint
+ * */
+void FlowRecorder::load_State(Checkpoint *cp)
+{
+	this->stop_Writer();
+	this->seed = cp->read_Int();
+	this->realization = cp->read_Int();
+	this->changes = cp->read_Int();
+	this->block_First = cp->read_Int();
+	this->name = cp->restore_FileSize();
+	this->flows.assign(this->flows.size(),0);
+	if (this->realization != -1) this->start_Writer();
+
+	return;
+}
@@ -0,0 +1,93 @@
+//Class FlowRecorder, that keeps in memory the individuals of each species that migrated through each edge of the
+//landscape (source -> target) and writes them in blocks, one block every SAVE-EACH iterations (see
+//Dynamic::MonteCarlo). Only the (source, target, species) with migrations are written. It replaces the old
+//realMigration.dat, that was shared by all the runs and only had the last species of each site.
+//
+//The layout of the file is FLOWS_LAYOUT (it can be changed at compile time):
+//- FLOWS_NONE   - no file
+//- FLOWS_CSV    - migration_flows_seed_S_real_R_changes_C.csv, with the line "first,last,source,target,species,individuals"
+//                 and then one line per flow of each block: the first and the last iterations of the block, the ids of
+//                 the sites and of the species and the individuals that migrated in the block
+//- FLOWS_BINARY - migration_flows_seed_S_real_R_changes_C.flw, each block is int32 [first][last][count] and 'count'
+//                 int32 [source][target][species][individuals]
+//
+//The blocks are formatted by the Monte Carlo and written by a background thread, so the iterations don't wait for
+//the disk. 'flush' waits until everything is written. save_State keeps the size of the file in a Checkpoint and
+//load_State cuts the file to that size and continues it.
+
+/***************************************************************************
+ *            FlowRecorder.h
+ *
+ *  Copyright  2009  User Charles Novaes de Santana & Alejandro Rozenfeld
+ *  Email charles.santana@gmail.com / alex@ifisc.uib-csic.es
+ ****************************************************************************/
+
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _FLOWRECORDER_H_
+#define _FLOWRECORDER_H_
+
+#include <pthread.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include "Checkpoint.h"
+
+using namespace::std;
+
+#define FLOWS_NONE 0
+#define FLOWS_CSV 1
+#define FLOWS_BINARY 2
+
+#ifndef FLOWS_LAYOUT
+#define FLOWS_LAYOUT FLOWS_CSV
+#endif
+
+class FlowRecorder
+{
+	private:
+		int layout;
+		int seed, realization, changes;//the file that is open now (realization = -1: none)
+		string name;
+		int nEdges, nSpecies;
+		vector<int> source, target;//the sites (0..N-1) of each edge
+		vector<int> flows;//the individuals of each species through each edge in the current block, sp*nEdges + edge
+		int block_First;//the first iteration of the current block
+		pthread_t writer;
+		pthread_mutex_t lock;
+		pthread_cond_t has_Work, is_Idle;
+		deque<string> pending;//the blocks that the writer didn't write yet
+		int busy, stop, running;
+		static void* run_Writer(void *recorder);
+		void start_Writer(void);
+		void stop_Writer(void);
+	public:
+		void init(vector<int> &source, vector<int> &target, int nSpecies);
+		int is_Open(int seed, int realization, int changes);
+		void open(string dir, int seed, int realization, int changes, int first);
+		void add_Flow(int edge, int sp, int n) { if (this->nEdges) this->flows[sp*this->nEdges + edge] += n; }
+		void end_Block(int last);
+		void flush(void);
+		void close(int last);
+		void save_State(Checkpoint *cp);
+		void load_State(Checkpoint *cp);
+		FlowRecorder();
+		~FlowRecorder();
+};
+
+#endif
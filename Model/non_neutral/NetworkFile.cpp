@@ -0,0 +1,219 @@
+#include "NetworkFile.h"
+#include <iostream>
+#include <fstream>
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+NetworkFile::NetworkFile()
+{
+	memset(&this->header,0,sizeof(tNetworkHeader));
+	this->foodweb_Vertices = NULL;
+	this->landscape_Vertices = NULL;
+	this->edges = NULL;
+	this->map = NULL;
+	this->map_Size = 0;
+}
+
+NetworkFile::~NetworkFile()
+{
+	this->close();
+}
+
+void NetworkFile::close(void)
+{
+	if (this->map != NULL) munmap(this->map,this->map_Size);
+	this->map = NULL;
+	this->map_Size = 0;
+	this->foodweb_Memory.clear();
+	this->landscape_Memory.clear();
+	this->edges_Memory.clear();
+	this->foodweb_Vertices = NULL;
+	this->landscape_Vertices = NULL;
+	this->edges = NULL;
+	memset(&this->header,0,sizeof(tNetworkHeader));
+	return;
+}
+
+/*To open the food web or the landscape ('kind') 'name', binary or text. Returns 1 if the file was opened and
+ * it is valid, 0 otherwise (with a message in cerr)
+ * */
+int NetworkFile::open(string name, int kind)
+{
+	ifstream f1;
+	char magic[4];
+
+	this->close();
+	f1.open(name.c_str(),ifstream::binary);
+	if (!f1.is_open())
+	{
+		cerr << "FILE " << name << " DOESN'T EXIST!" << endl;
+		return(0);
+	}
+	memset(magic,0,4);
+	f1.read(magic,4);
+	f1.close();
+	if (memcmp(magic,NETWORK_MAGIC,4) == 0)
+	{
+		if (!this->open_Binary(name,kind)) return(0);
+	}
+	else if (!this->open_Text(name,kind)) return(0);
+
+	return(this->validate(name));
+}
+
+int NetworkFile::open_Binary(string name, int kind)
+{
+	int fd;
+	struct stat st;
+	unsigned long vertex,expected;
+
+	fd = ::open(name.c_str(),O_RDONLY);
+	if (fd < 0) return(0);
+	if ((fstat(fd,&st) != 0) || ((unsigned long)st.st_size < sizeof(tNetworkHeader)) || (read(fd,&this->header,sizeof(tNetworkHeader)) != (int)sizeof(tNetworkHeader)))
+	{
+		::close(fd);
+		cerr << "FILE " << name << " IS NOT A VALID BINARY NETWORK!" << endl;
+		return(0);
+	}
+	vertex = (kind == NETWORK_FOODWEB) ? sizeof(tFoodWebVertex) : sizeof(tLandscapeVertex);
+	expected = sizeof(tNetworkHeader) + (unsigned long)this->header.nVertices*vertex + (unsigned long)this->header.nEdges*sizeof(tNetworkEdge);
+	if ((this->header.version != NETWORK_VERSION) || (this->header.kind != kind) || (this->header.nVertices < 1) || (this->header.nEdges < 0) || ((unsigned long)st.st_size != expected))
+	{
+		::close(fd);
+		cerr << "FILE " << name << " IS NOT A VALID BINARY " << ((kind == NETWORK_FOODWEB) ? "FOOD WEB" : "LANDSCAPE") << "!" << endl;
+		return(0);
+	}
+	this->map_Size = st.st_size;
+	this->map = mmap(NULL,this->map_Size,PROT_READ,MAP_SHARED,fd,0);
+	::close(fd);
+	if (this->map == MAP_FAILED)
+	{
+		this->map = NULL;
+		return(0);
+	}
+	if (kind == NETWORK_FOODWEB) this->foodweb_Vertices = (const tFoodWebVertex*)((const char*)this->map + sizeof(tNetworkHeader));
+	else this->landscape_Vertices = (const tLandscapeVertex*)((const char*)this->map + sizeof(tNetworkHeader));
+	this->edges = (const tNetworkEdge*)((const char*)this->map + sizeof(tNetworkHeader) + (unsigned long)this->header.nVertices*vertex);
+
+	return(1);
+}
+
+int NetworkFile::open_Text(string name, int kind)
+{
+	ifstream f1;
+	int i,nVert;
+	string aux;
+	tFoodWebVertex fw;
+	tLandscapeVertex ls;
+	tNetworkEdge e;
+
+	f1.open(name.c_str());
+	f1 >> aux >> nVert;
+	for (i=0;(i<nVert)&&(f1.good());i++)
+	{
+		if (kind == NETWORK_FOODWEB)
+		{
+			f1 >> fw.id >> aux >> fw.bp >> fw.dp >> fw.ndp >> fw.mp >> fw.nIni;
+			this->foodweb_Memory.push_back(fw);
+		}
+		else
+		{
+			f1 >> ls.id >> aux >> ls.cc;
+			this->landscape_Memory.push_back(ls);
+		}
+	}
+	if ((f1.fail()) || (nVert < 1))
+	{
+		cerr << "FILE " << name << " HAS WRONG VERTICES!" << endl;
+		return(0);
+	}
+	f1 >> aux;
+	e.weight = 1;
+	while (((kind == NETWORK_FOODWEB) && (f1 >> e.i >> e.j)) || ((kind == NETWORK_LANDSCAPE) && (f1 >> e.i >> e.j >> e.weight)))
+	{
+		this->edges_Memory.push_back(e);
+	}
+	f1.close();
+	this->header.version = NETWORK_VERSION;
+	this->header.kind = kind;
+	this->header.nVertices = nVert;
+	this->header.nEdges = (int)this->edges_Memory.size();
+	this->foodweb_Vertices = this->foodweb_Memory.size() ? &this->foodweb_Memory[0] : NULL;
+	this->landscape_Vertices = this->landscape_Memory.size() ? &this->landscape_Memory[0] : NULL;
+	this->edges = this->edges_Memory.size() ? &this->edges_Memory[0] : NULL;
+
+	return(1);
+}
+
+/*The ids of the vertices must be 1..N (each one only once) and the edges must link those ids
+ * */
+int NetworkFile::validate(string name)
+{
+	int i,k,n,id;
+	vector<char> seen;
+
+	n = this->header.nVertices;
+	seen.assign(n,0);
+	for (i=0;i<n;i++)
+	{
+		id = (this->header.kind == NETWORK_FOODWEB) ? this->foodweb_Vertices[i].id : this->landscape_Vertices[i].id;
+		if ((id < 1) || (id > n) || (seen[id-1]))
+		{
+			cerr << "FILE " << name << ": WRONG ID OF THE VERTEX " << i+1 << " (" << id << ")" << endl;
+			return(0);
+		}
+		seen[id-1] = 1;
+	}
+	for (k=0;k<this->header.nEdges;k++)
+	{
+		if ((this->edges[k].i < 1) || (this->edges[k].i > n) || (this->edges[k].j < 1) || (this->edges[k].j > n))
+		{
+			cerr << "FILE " << name << ": THE EDGE " << k+1 << " (" << this->edges[k].i << " " << this->edges[k].j << ") IS OUT OF 1.." << n << endl;
+			return(0);
+		}
+	}
+
+	return(1);
+}
+
+/*To write the network as a binary file. Returns 1 if it was written
+ * */
+int NetworkFile::write(string name)
+{
+	ofstream f1;
+	tNetworkHeader aux;
+
+	aux = this->header;
+	memcpy(aux.magic,NETWORK_MAGIC,4);
+	aux.version = NETWORK_VERSION;
+	f1.open(name.c_str(),ofstream::binary | ofstream::trunc);
+	if (!f1.is_open()) return(0);
+	f1.write((const char*)&aux,sizeof(tNetworkHeader));
+	if (aux.kind == NETWORK_FOODWEB) f1.write((const char*)this->foodweb_Vertices,aux.nVertices*sizeof(tFoodWebVertex));
+	else f1.write((const char*)this->landscape_Vertices,aux.nVertices*sizeof(tLandscapeVertex));
+	if (aux.nEdges) f1.write((const char*)this->edges,aux.nEdges*sizeof(tNetworkEdge));
+	f1.close();
+
+	return(!f1.fail());
+}
+
+/*To convert the network 'in' (text or binary) to the binary file 'out'
+ * */
+int NetworkFile::compile(string in, string out, int kind)
+{
+	NetworkFile n1;
+
+	if (!n1.open(in,kind)) return(0);
+	if (!n1.write(out))
+	{
+		cerr << "IT WAS NOT POSSIBLE TO WRITE " << out << endl;
+		return(0);
+	}
+	cerr << out << ": " << n1.get_NumberVertices() << " VERTICES, " << n1.get_NumberEdges() << " EDGES" << endl;
+
+	return(1);
+}
@@ -0,0 +1,112 @@
+//Class NetworkFile, to read the food web (FWNF) and the landscape (SNNF) files, in the text (Pajek) format
+//or in a compiled binary format that is mapped in memory (mmap) and used without parsing.
+//
+//The text files are:
+//- food web  - *Vertices N, N lines "ID NAME BP DP NDP MP NINI", *Arcs, lines "PREDATOR PREY"
+//- landscape - *Vertices N, N lines "ID NAME CC", *Edges, lines "SITE NEIGHBOR WEIGHT"
+//
+//The binary file is a header (tNetworkHeader, 32 bytes), the N vertices (tFoodWebVertex or tLandscapeVertex)
+//and the E edges (tNetworkEdge, weight 1 in the food web), in the order of the text file. It is written by
+//compile (./FoodWeb compile fw|snn FILE.net FILE.netb). 'open' knows the format by the first bytes, so the
+//binary files can be given as FWNF and SNNF.
+//
+//Both formats are validated when they are opened: the ids of the vertices must be 1..N, without repetitions,
+//and the edges must link vertices of 1..N.
+
+/***************************************************************************
+ *            NetworkFile.h
+ *
+ *  Copyright  2009  User Charles Novaes de Santana & Alejandro Rozenfeld
+ *  Email charles.santana@gmail.com / alex@ifisc.uib-csic.es
+ ****************************************************************************/
+
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _NETWORKFILE_H_
+#define _NETWORKFILE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace::std;
+
+#define NETWORK_MAGIC "FWNB"
+#define NETWORK_VERSION 1
+
+#define NETWORK_FOODWEB 1
+#define NETWORK_LANDSCAPE 2
+
+typedef struct sNetworkHeader
+{
+	char magic[4];//"FWNB"
+	int32_t version;
+	int32_t kind;//NETWORK_FOODWEB or NETWORK_LANDSCAPE
+	int32_t nVertices;
+	int32_t nEdges;
+	int32_t reserved[3];
+}tNetworkHeader;
+
+typedef struct sFoodWebVertex
+{
+	int32_t id;
+	float bp, dp, ndp, mp;
+	int32_t nIni;
+}tFoodWebVertex;
+
+typedef struct sLandscapeVertex
+{
+	int32_t id;
+	int32_t cc;
+}tLandscapeVertex;
+
+typedef struct sNetworkEdge
+{
+	int32_t i, j;
+	int32_t weight;
+}tNetworkEdge;
+
+class NetworkFile
+{
+	private:
+		tNetworkHeader header;
+		const tFoodWebVertex *foodweb_Vertices;
+		const tLandscapeVertex *landscape_Vertices;
+		const tNetworkEdge *edges;
+		void *map;//the mapped file (binary files)
+		unsigned long map_Size;
+		vector<tFoodWebVertex> foodweb_Memory;//the vertices and edges of the text files
+		vector<tLandscapeVertex> landscape_Memory;
+		vector<tNetworkEdge> edges_Memory;
+		void close(void);
+		int open_Binary(string name, int kind);
+		int open_Text(string name, int kind);
+		int validate(string name);
+	public:
+		int open(string name, int kind);
+		int write(string name);
+		static int compile(string in, string out, int kind);
+		int get_NumberVertices(void) { return(this->header.nVertices); }
+		int get_NumberEdges(void) { return(this->header.nEdges); }
+		const tFoodWebVertex* get_FoodWebVertex(int i) { return(&this->foodweb_Vertices[i]); }
+		const tLandscapeVertex* get_LandscapeVertex(int i) { return(&this->landscape_Vertices[i]); }
+		const tNetworkEdge* get_Edge(int k) { return(&this->edges[k]); }
+		NetworkFile();
+		~NetworkFile();
+};
+
+#endif
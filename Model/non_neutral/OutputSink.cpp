@@ -0,0 +1,283 @@
+#include "OutputSink.h"
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#ifdef OUTPUT_ZLIB
+#include <zlib.h>
+#endif
+
+OutputSink::OutputSink()
+{
+	this->layout = OUTPUT_LAYOUT;
+	this->seed = 0;
+	this->realization = -1;
+	this->changes = 0;
+	this->nSites = 0;
+	this->nSamples = 0;
+	this->buffered = 0;
+}
+
+OutputSink::~OutputSink()
+{
+	this->flush();
+}
+
+void OutputSink::set_Layout(int layout)
+{
+	this->flush();
+	this->layout = layout;
+	this->realization = -1;
+	return;
+}
+
+int OutputSink::is_Open(int seed, int realization, int changes)
+{
+	return((this->realization != -1) && (this->seed == seed) && (this->realization == realization) && (this->changes == changes));
+}
+
+/*To write the buffers of the previous files and to start the files of (seed, realization, changes) in
+ * the directory 'dir' ("" or ending with '/')
+ * */
+void OutputSink::open(string dir, int seed, int realization, int changes, int nSpecies, int nSites)
+{
+	int sp;
+	ostringstream os1;
+	ofstream f1;
+	tAbundanceHeader header;
+
+	this->flush();
+	this->seed = seed;
+	this->realization = realization;
+	this->changes = changes;
+	this->nSites = nSites;
+	this->nSamples = 0;
+	this->names.clear();
+	if (this->layout == OUTPUT_BINARY)
+	{
+		os1 << dir << "output_species_seed_" << seed << "_real_" << realization << "_changes_" << changes << ".fwab";
+#ifdef OUTPUT_ZLIB
+		os1 << ".gz";
+#endif
+		this->names.push_back(os1.str());
+		memset(&header,0,sizeof(tAbundanceHeader));
+		memcpy(header.magic,ABUNDANCE_MAGIC,4);
+		header.version = ABUNDANCE_VERSION;
+		header.nSpecies = nSpecies;
+		header.nSites = nSites;
+		header.seed = seed;
+		header.realization = realization;
+		header.changes = changes;
+#ifdef OUTPUT_ZLIB
+		header.compressed = 1;
+#endif
+		f1.open(this->names.at(0).c_str(),ofstream::binary | ofstream::trunc);//the header is never compressed
+		f1.write((const char*)&header,sizeof(tAbundanceHeader));
+		f1.close();
+	}
+	else if (this->layout == OUTPUT_COMBINED)
+	{
+		os1 << dir << "output_species_all_seed_" << seed << "_real_" << realization << "_changes_" << changes << ".dat";
+		this->names.push_back(os1.str());
+	}
+	else
+	{
+		for (sp=0;sp<nSpecies;sp++)
+		{
+			ostringstream os2;
+			os2 << dir << "output_species_";
+			os2.width(3);
+			os2.fill('0');
+			os2 << sp+1;
+			os2 << "_seed_" << seed << "_real_" << realization << "_changes_" << changes << ".dat";
+			this->names.push_back(os2.str());
+		}
+	}
+	this->buffers.assign(this->names.size(),string());
+
+	return;
+}
+
+void OutputSink::append_Line(string *buf, int *nInd, int nSites)
+{
+	int st;
+	char num[16];
+
+	for (st=0;st<nSites;st++)
+	{
+		sprintf(num,"%d ",nInd[st]);
+		buf->append(num);
+	}
+	buf->append("\n");
+
+	return;
+}
+
+/*To start the sample of the iteration 'it' (before the add_Sample of all the species)
+ * */
+void OutputSink::begin_Sample(int it)
+{
+	int32_t it32;
+
+	if (this->layout == OUTPUT_BINARY)
+	{
+		it32 = it;
+		this->buffers.at(0).append((const char*)&it32,sizeof(int32_t));
+		this->buffered += sizeof(int32_t);
+		this->nSamples++;
+	}
+	return;
+}
+
+/*The individuals of the species 'sp' (index) in each site at the iteration 'it'
+ * */
+void OutputSink::add_Sample(int it, int sp, int *nInd, int nSites)
+{
+	string *buf;
+	unsigned long before;
+	char head[32];
+
+	if (this->layout == OUTPUT_BINARY)//int is int32 in all the machines we use
+	{
+		this->buffers.at(0).append((const char*)nInd,nSites*sizeof(int32_t));
+		this->buffered += nSites*sizeof(int32_t);
+		return;
+	}
+	if (this->layout == OUTPUT_COMBINED)
+	{
+		buf = &this->buffers.at(0);
+		before = buf->size();
+		sprintf(head,"%d %d ",it,sp+1);
+		buf->append(head);
+	}
+	else
+	{
+		buf = &this->buffers.at(sp);
+		before = buf->size();
+	}
+	this->append_Line(buf,nInd,nSites);
+	this->buffered += buf->size() - before;
+
+	return;
+}
+
+/*To write the buffers if they are too big
+ * */
+void OutputSink::end_Sample(void)
+{
+	if (this->buffered > OUTPUT_BUFFER_SIZE) this->flush();
+	return;
+}
+
+void OutputSink::flush(void)
+{
+	int i;
+	ofstream f1;
+
+	if (this->buffered == 0) return;
+	if (this->layout == OUTPUT_BINARY)
+	{
+		this->flush_Binary();
+		return;
+	}
+	for (i=0;i<(int)this->names.size();i++)
+	{
+		if (this->buffers.at(i).size() == 0) continue;
+		f1.open(this->names.at(i).c_str(),ofstream::app);
+		f1.write(this->buffers.at(i).data(),this->buffers.at(i).size());
+		f1.close();
+		this->buffers.at(i).clear();
+	}
+	this->buffered = 0;
+
+	return;
+}
+
+/*To append the samples to the binary file and to update the number of samples of its header
+ * */
+void OutputSink::flush_Binary(void)
+{
+	string *buf;
+
+	buf = &this->buffers.at(0);
+#ifdef OUTPUT_ZLIB
+	gzFile gz;
+
+	gz = gzopen(this->names.at(0).c_str(),"ab");//a new gzip member after the previous ones
+	if (gz != NULL)
+	{
+		gzwrite(gz,buf->data(),buf->size());
+		gzclose(gz);
+	}
+#else
+	fstream f1;
+	int32_t n;
+
+	f1.open(this->names.at(0).c_str(),fstream::in | fstream::out | fstream::binary);
+	f1.seekp(0,fstream::end);
+	f1.write(buf->data(),buf->size());
+	n = this->nSamples;
+	f1.seekp(offsetof(tAbundanceHeader,nSamples),fstream::beg);
+	f1.write((const char*)&n,sizeof(int32_t));
+	f1.close();
+#endif
+	buf->clear();
+	this->buffered = 0;
+
+	return;
+}
+
+/*To write the buffers and to save the files that are open, with their sizes
+ * */
+void OutputSink::save_State(Checkpoint *cp)
+{
+	int i;
+
+	this->flush();
+	cp->write_Int(this->layout);
+	cp->write_Int(this->seed);
+	cp->write_Int(this->realization);
+	cp->write_Int(this->changes);
+	cp->write_Int(this->nSites);
+	cp->write_Int(this->nSamples);
+	cp->write_Int((int)this->names.size());
+	for (i=0;i<(int)this->names.size();i++) cp->write_FileSize(this->names.at(i));
+
+	return;
+}
+
+/*To continue the files saved by save_State, without what was written in them after the checkpoint
+ * */
+void OutputSink::load_State(Checkpoint *cp)
+{
+	int i,n;
+
+	this->layout = cp->read_Int();
+	this->seed = cp->read_Int();
+	this->realization = cp->read_Int();
+	this->changes = cp->read_Int();
+	this->nSites = cp->read_Int();
+	this->nSamples = cp->read_Int();
+	n = cp->read_Int();
+	this->names.clear();
+	for (i=0;(i<n)&&(cp->is_Good());i++)
+	{
+		this->names.push_back(cp->restore_FileSize());
+	}
+	this->buffers.assign(this->names.size(),string());
+	this->buffered = 0;
+#ifndef OUTPUT_ZLIB
+	if ((this->layout == OUTPUT_BINARY) && (this->names.size()))//the header could have the samples written after the checkpoint
+	{
+		fstream f1;
+		int32_t n32;
+
+		f1.open(this->names.at(0).c_str(),fstream::in | fstream::out | fstream::binary);
+		n32 = this->nSamples;
+		f1.seekp(offsetof(tAbundanceHeader,nSamples),fstream::beg);
+		f1.write((const char*)&n32,sizeof(int32_t));
+		f1.close();
+	}
+#endif
+
+	return;
+}
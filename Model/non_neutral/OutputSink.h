@@ -0,0 +1,95 @@
+//Class OutputSink, that keeps in memory the time series written by Dynamic::print_File (the individuals
+//of each species in each site, every SHOW-EACH iterations) and writes them to the files in large blocks,
+//instead of opening and closing one file per species at each sample.
+//
+//The layout of the files is chosen with set_Layout (the default is OUTPUT_LAYOUT, that can be changed at
+//compile time):
+//- OUTPUT_PER_SPECIES - one file per species, output_species_NNN_seed_S_real_R_changes_C.dat, with one line
+//                       per sample with the individuals of each site (the same files as before)
+//- OUTPUT_COMBINED    - only one file, output_species_all_seed_S_real_R_changes_C.dat, with one line
+//                       per sample and species: ITERATION SPECIES_ID individuals of each site
+//- OUTPUT_BINARY      - only one binary file, output_species_seed_S_real_R_changes_C.fwab, with int32 blocks
+//                       (sample x species x site), see AbundanceReader. With OUTPUT_ZLIB the file is
+//                       compressed (.fwab.gz)
+//
+//The text files are opened in append mode, just like before (the binary file is created again). The data are written when the buffers have more
+//than OUTPUT_BUFFER_SIZE bytes, in 'flush' and when the sink is destroyed.
+//
+//save_State writes the buffers and keeps the files that are open and their sizes in a Checkpoint; load_State
+//continues those files, cut to the sizes of the checkpoint.
+
+/***************************************************************************
+ *            OutputSink.h
+ *
+ *  Copyright  2009  User Charles Novaes de Santana & Alejandro Rozenfeld
+ *  Email charles.santana@gmail.com / alex@ifisc.uib-csic.es
+ ****************************************************************************/
+
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _OUTPUTSINK_H_
+#define _OUTPUTSINK_H_
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "AbundanceReader.h"
+#include "Checkpoint.h"
+
+using namespace::std;
+
+#define OUTPUT_PER_SPECIES 1
+#define OUTPUT_COMBINED 2
+#define OUTPUT_BINARY 3
+
+#ifndef OUTPUT_LAYOUT
+#define OUTPUT_LAYOUT OUTPUT_PER_SPECIES
+#endif
+
+#ifndef OUTPUT_BUFFER_SIZE
+#define OUTPUT_BUFFER_SIZE (4*1024*1024)
+#endif
+
+class OutputSink
+{
+	private:
+		int layout;
+		int seed, realization, changes;//the files that are open now (realization = -1: none)
+		int nSites;
+		int nSamples;//samples written in the binary file
+		unsigned long buffered;//bytes in the buffers
+		vector<string> names;//one per species (OUTPUT_PER_SPECIES) or only one (OUTPUT_COMBINED)
+		vector<string> buffers;
+		void append_Line(string *buf, int *nInd, int nSites);
+		void flush_Binary(void);
+	public:
+		void set_Layout(int layout);
+		int is_Open(int seed, int realization, int changes);
+		void open(string dir, int seed, int realization, int changes, int nSpecies, int nSites);
+		void begin_Sample(int it);
+		void add_Sample(int it, int sp, int *nInd, int nSites);
+		void end_Sample(void);
+		void flush(void);
+		void save_State(Checkpoint *cp);
+		void load_State(Checkpoint *cp);
+		OutputSink();
+		~OutputSink();
+};
+
+#endif
@@ -0,0 +1,145 @@
+#include "Profiler.h"
+#include <fstream>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+Profiler::Profiler()
+{
+	this->init();
+}
+
+/*To start again (one slot per thread that OpenMP can use, without any time or event)
+ * */
+void Profiler::init(void)
+{
+	int n;
+
+#ifdef _OPENMP
+	n = omp_get_max_threads();
+#else
+	n = 1;
+#endif
+	this->slots.resize(n);
+	memset(&this->slots[0],0,n*sizeof(tProfileSlot));
+	memset(&this->total,0,sizeof(tProfileSlot));
+	this->steps.clear();
+	this->step_Start = Profiler::get_Time();
+
+	return;
+}
+
+double Profiler::get_Time(void)
+{
+#ifdef _OPENMP
+	return(omp_get_wtime());
+#else
+	struct timeval tv;
+
+	gettimeofday(&tv,NULL);
+	return(tv.tv_sec + 1e-6*tv.tv_usec);
+#endif
+}
+
+string Profiler::get_PhaseName(int phase)
+{
+	const char *names[PROFILE_PHASES] = {"step","sites","soc","dynamic_prey","migration","set_pref","coexistence","print"};
+
+	return(names[phase]);
+}
+
+string Profiler::get_KindName(int kind)
+{
+	const char *names[PROFILE_KINDS] = {"events","births","deaths","predations","migrations"};
+
+	return(names[kind]);
+}
+
+void Profiler::sum_Slots(tProfileSlot *sum)
+{
+	int i,k;
+
+	memset(sum,0,sizeof(tProfileSlot));
+	for (i=0;i<(int)this->slots.size();i++)
+	{
+		for (k=0;k<PROFILE_PHASES;k++)
+		{
+			sum->time[k] += this->slots[i].time[k];
+			sum->calls[k] += this->slots[i].calls[k];
+		}
+		for (k=0;k<PROFILE_KINDS;k++) sum->count[k] += this->slots[i].count[k];
+	}
+
+	return;
+}
+
+/*The end of the iteration 'it' (outside of the parallel loops): its times and events are kept for write_Steps
+ * */
+void Profiler::end_Step(int it)
+{
+	int k;
+	tProfileSlot sum;
+	tProfileStep step;
+
+	this->add_Time(PROFILE_STEP,Profiler::get_Time() - this->step_Start);
+	this->sum_Slots(&sum);
+	step.it = it;
+	for (k=0;k<PROFILE_PHASES;k++) step.time[k] = sum.time[k] - this->total.time[k];
+	for (k=0;k<PROFILE_KINDS;k++) step.count[k] = sum.count[k] - this->total.count[k];
+	this->steps.push_back(step);
+	this->total = sum;
+
+	return;
+}
+
+/*The table of the phases (calls, seconds, microseconds per call and % of the time of the iterations) and the total
+ * of each kind of event
+ * */
+void Profiler::print_Summary(ostream &out)
+{
+	int k;
+	tProfileSlot sum;
+	char line[128];
+
+	this->sum_Slots(&sum);
+	out << "PROFILE OF " << this->steps.size() << " ITERATIONS (" << this->slots.size() << " THREADS)" << endl;
+	sprintf(line,"%-14s %12s %12s %12s %8s","PHASE","CALLS","SECONDS","US/CALL","%STEP");
+	out << line << endl;
+	for (k=0;k<PROFILE_PHASES;k++)
+	{
+		sprintf(line,"%-14s %12lu %12.4f %12.3f %8.2f",Profiler::get_PhaseName(k).c_str(),sum.calls[k],sum.time[k],(sum.calls[k]) ? 1e6*sum.time[k]/sum.calls[k] : 0.0,(sum.time[PROFILE_STEP] > 0) ? 100.0*sum.time[k]/sum.time[PROFILE_STEP] : 0.0);
+		out << line << endl;
+	}
+	for (k=0;k<PROFILE_KINDS;k++)
+	{
+		sprintf(line,"%-14s %12lu %12.1f/IT",Profiler::get_KindName(k).c_str(),sum.count[k],(this->steps.size()) ? (double)sum.count[k]/this->steps.size() : 0.0);
+		out << line << endl;
+	}
+
+	return;
+}
+
+/*The times (seconds) and the events of each iteration, as CSV. Returns 0 if the file couldn't be written
+ * */
+int Profiler::write_Steps(string name)
+{
+	int i,k;
+	ofstream f1;
+
+	f1.open(name.c_str(),ofstream::trunc);
+	if (!f1.is_open()) return(0);
+	f1 << "iteration";
+	for (k=0;k<PROFILE_PHASES;k++) f1 << "," << Profiler::get_PhaseName(k);
+	for (k=0;k<PROFILE_KINDS;k++) f1 << "," << Profiler::get_KindName(k);
+	f1 << endl;
+	for (i=0;i<(int)this->steps.size();i++)
+	{
+		f1 << this->steps[i].it;
+		for (k=0;k<PROFILE_PHASES;k++) f1 << "," << this->steps[i].time[k];
+		for (k=0;k<PROFILE_KINDS;k++) f1 << "," << this->steps[i].count[k];
+		f1 << endl;
+	}
+	f1.close();
+
+	return(!f1.fail());
+}
@@ -0,0 +1,142 @@
+//Class Profiler, the time of the parts of the Monte Carlo and the number of events of each iteration. It is only
+//used when the program is compiled with MC_PROFILE (make PROFILE=1): without it PROFILE_SCOPE and PROFILE_COUNT
+//are empty and the Monte Carlo doesn't pay anything.
+//
+//- PROFILE_SCOPE(profiler,phase) - the time from this line to the end of the block is added to 'phase'
+//- PROFILE_COUNT(profiler,kind,n) - 'n' events of 'kind' in the current iteration
+//- PROFILE_BEGIN_STEP(profiler) and PROFILE_END_STEP(profiler,it) - the begining and the end of the iteration 'it'
+//
+//Each thread of OpenMP adds to its own slot, so the phases inside the parallel loop of the sites (PROFILE_SOC,
+//PROFILE_PREY) are the sum of the times of all the threads. The phases can be nested (PROFILE_PREF is inside
+//PROFILE_MIGRATION, and everything is inside PROFILE_STEP). At the end of the Monte Carlo, print_Summary writes the
+//table of the phases and write_Steps writes profile_seed_S_real_R_changes_C.csv, with one line per iteration.
+
+/***************************************************************************
+ *            Profiler.h
+ *
+ *  Copyright  2009  User Charles Novaes de Santana & Alejandro Rozenfeld
+ *  Email charles.santana@gmail.com / alex@ifisc.uib-csic.es
+ ****************************************************************************/
+
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace::std;
+
+//phases
+#define PROFILE_STEP 0//one iteration of the Monte Carlo
+#define PROFILE_SITES 1//the events of all the sites (the parallel loop, or Gillespie_Step)
+#define PROFILE_SOC 2//SOC and SOC_Site
+#define PROFILE_PREY 3//DynamicPrey
+#define PROFILE_MIGRATION 4//Migration
+#define PROFILE_PREF 5//set_Pref
+#define PROFILE_COEXISTENCE 6//CoexistenceNetworks
+#define PROFILE_PRINT 7//print_File, print_TimeSeriesOfSpecies and print_SOC_SpaceOfParameters
+#define PROFILE_PHASES 8
+
+//kinds of events
+#define PROFILE_EVENTS 0//individuals chosen to act
+#define PROFILE_BIRTHS 1
+#define PROFILE_DEATHS 2//natural deaths
+#define PROFILE_PREDATIONS 3//preys that died eaten
+#define PROFILE_MIGRATIONS 4//individuals that migrated
+#define PROFILE_KINDS 5
+
+typedef struct sProfileSlot
+{
+	double time[PROFILE_PHASES];
+	unsigned long calls[PROFILE_PHASES];
+	unsigned long count[PROFILE_KINDS];
+	char pad[64];//the slots of two threads are not in the same cache line
+}tProfileSlot;
+
+typedef struct sProfileStep
+{
+	int it;
+	double time[PROFILE_PHASES];
+	unsigned long count[PROFILE_KINDS];
+}tProfileStep;
+
+class Profiler
+{
+	private:
+		vector<tProfileSlot> slots;//one per thread
+		tProfileSlot total;//the sum of the slots at the end of the last iteration
+		vector<tProfileStep> steps;
+		double step_Start;
+		tProfileSlot* get_Slot(void);
+		void sum_Slots(tProfileSlot *sum);
+	public:
+		static double get_Time(void);
+		static string get_PhaseName(int phase);
+		static string get_KindName(int kind);
+		void init(void);
+		void add_Time(int phase, double t) { tProfileSlot *s = this->get_Slot(); s->time[phase] += t; s->calls[phase]++; }
+		void count(int kind, unsigned long n) { this->get_Slot()->count[kind] += n; }
+		void begin_Step(void) { this->step_Start = Profiler::get_Time(); }
+		void end_Step(int it);
+		void print_Summary(ostream &out);
+		int write_Steps(string name);
+		Profiler();
+};
+
+/*The time from the constructor to the destructor is added to 'phase'
+ * */
+class ProfileScope
+{
+	private:
+		Profiler *profiler;
+		int phase;
+		double start;
+	public:
+		ProfileScope(Profiler *profiler, int phase) { this->profiler = profiler; this->phase = phase; this->start = Profiler::get_Time(); }
+		~ProfileScope() { this->profiler->add_Time(this->phase,Profiler::get_Time() - this->start); }
+};
+
+inline tProfileSlot* Profiler::get_Slot(void)
+{
+#ifdef _OPENMP
+	return(&this->slots[omp_get_thread_num()]);
+#else
+	return(&this->slots[0]);
+#endif
+}
+
+#define PROFILE_JOIN2(a,b) a##b
+#define PROFILE_JOIN(a,b) PROFILE_JOIN2(a,b)
+#ifdef MC_PROFILE
+#define PROFILE_SCOPE(profiler,phase) ProfileScope PROFILE_JOIN(profile_Scope,__LINE__)(profiler,phase)
+#define PROFILE_COUNT(profiler,kind,n) (profiler)->count(kind,n)
+#define PROFILE_BEGIN_STEP(profiler) (profiler)->begin_Step()
+#define PROFILE_END_STEP(profiler,it) (profiler)->end_Step(it)
+#else
+#define PROFILE_SCOPE(profiler,phase)
+#define PROFILE_COUNT(profiler,kind,n)
+#define PROFILE_BEGIN_STEP(profiler)
+#define PROFILE_END_STEP(profiler,it)
+#endif
+
+#endif
@@ -0,0 +1,138 @@
+#include "Random.h"
+#include <math.h>
+
+Random::Random()
+{
+	this->set_Seed(0,0,0);
+}
+
+void Random::set_Seed(unsigned long seed, unsigned long realization, unsigned long stream)
+{
+	uint64_t x, key;
+	int i;
+
+	x = (uint64_t)seed;
+	key = splitmix64(&x);
+	x = key ^ (uint64_t)realization;
+	key = splitmix64(&x);
+	x = key ^ (uint64_t)stream;
+	for (i=0;i<4;i++) this->s[i] = splitmix64(&x);//never all zero
+
+	return;
+}
+
+void Random::get_State(uint64_t *state)
+{
+	int i;
+
+	for (i=0;i<4;i++) state[i] = this->s[i];
+
+	return;
+}
+
+void Random::set_State(const uint64_t *state)
+{
+	int i;
+
+	for (i=0;i<4;i++) this->s[i] = state[i];
+
+	return;
+}
+
+/*Integer in [0,n), using the multiply-and-reject method of Lemire (2019) to avoid the bias of the modulo.
+ * */
+int Random::get_Int(int n)
+{
+	uint64_t m;
+	uint32_t x, l, t;
+
+	x = (uint32_t)(this->next() >> 32);
+	m = (uint64_t)x*(uint64_t)n;
+	l = (uint32_t)m;
+	if (l < (uint32_t)n)
+	{
+		t = (uint32_t)(-n) % (uint32_t)n;
+		while (l < t)
+		{
+			x = (uint32_t)(this->next() >> 32);
+			m = (uint64_t)x*(uint64_t)n;
+			l = (uint32_t)m;
+		}
+	}
+
+	return((int)(m >> 32));
+}
+
+double Random::get_Exponential(double rate)
+{
+	double u;
+
+	if (rate <= 0) return(HUGE_VAL);
+	do
+	{
+		u = this->get_UniformDouble();
+	} while (u <= 0);
+
+	return(-log(u)/rate);
+}
+
+/*log(k!) with lgamma_r: lgamma writes the global signgam, and get_Binomial is called by the sites of the tau-leap in
+ * parallel
+ * */
+static double log_Factorial(int k)
+{
+	int sign;
+
+	return(lgamma_r(k + 1.0,&sign));
+}
+
+/*Number of successes of 'n' trials with probability 'p'
+ * */
+int Random::get_Binomial(int n, double p)
+{
+	double q,u,v,us,spq,a,b,c,alpha,vr,lpq,h,f;
+	int k,m,flip;
+
+	if ((n <= 0) || (p <= 0.0)) return(0);
+	if (p >= 1.0) return(n);
+	flip = (p > 0.5);
+	if (flip) p = 1.0 - p;
+	q = 1.0 - p;
+	if (n*p < 10.0)//inversion: the probabilities of 0, 1, 2... successes until the uniform is reached
+	{
+		u = this->get_UniformDouble();
+		f = pow(q,n);
+		k = 0;
+		while ((u > f) && (k < n))
+		{
+			u -= f;
+			f *= (p/q)*(double)(n - k)/(double)(k + 1);
+			k++;
+		}
+		return(flip ? n - k : k);
+	}
+	spq = sqrt(n*p*q);
+	b = 1.15 + 2.53*spq;
+	a = -0.0873 + 0.0248*b + 0.01*p;
+	c = n*p + 0.5;
+	alpha = (2.83 + 5.1/b)*spq;
+	vr = 0.92 - 4.2/b;
+	lpq = log(p/q);
+	m = (int)floor((n + 1)*p);
+	h = log_Factorial(m) + log_Factorial(n - m);
+	while (1)
+	{
+		u = this->get_UniformDouble() - 0.5;
+		v = this->get_UniformDouble();
+		us = 0.5 - fabs(u);
+		if ((us <= 0.0) || (v <= 0.0)) continue;
+		f = floor((2.0*a/us + b)*u + c);
+		if ((f < 0.0) || (f > n)) continue;
+		k = (int)f;
+		if ((us >= 0.07) && (v <= vr)) break;
+		v = log(v*alpha/(a/(us*us) + b));
+		if (v <= h - log_Factorial(k) - log_Factorial(n - k) + (k - m)*lpq) break;
+	}
+
+	return(flip ? n - k : k);
+}
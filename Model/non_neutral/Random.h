@@ -0,0 +1,104 @@
+//Class Random, a random number generator with its own state, so each site (and each realization)
+//can have an independent stream of random numbers, reproducible from the SEED of the simulation.
+//
+//The generator is chosen at compile time with RNG_GENERATOR:
+//- RNG_XOSHIRO256 - xoshiro256** (Blackman & Vigna), the default
+//- RNG_SPLITMIX64 - splitmix64, a counter-based generator (the output is a hash of a counter)
+//
+//The streams are defined by (seed, realization, stream): the three numbers are mixed with
+//splitmix64 to fill the state of the generator.
+//
+//- get_Uniform  - a float in [0,1), with 24 random bits (instead of the 10^6 values of random()%PRECISION)
+//- get_UniformDouble - a double in [0,1), with 53 random bits
+//- get_Int      - an integer in [0,n), without the bias of random()%n
+//- get_Binomial - the number of successes of n trials with probability p (inversion for small n*p, the
+//                 BTRS rejection of Hormann (1993) for large n*p)
+//- get_Exponential - the waiting time of an event with 'rate' (HUGE_VAL if the rate is 0)
+
+/***************************************************************************
+ *            Random.h
+ *
+ *  Copyright  2009  User Charles Novaes de Santana & Alejandro Rozenfeld
+ *  Email charles.santana@gmail.com / alex@ifisc.uib-csic.es
+ ****************************************************************************/
+
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _RANDOM_H_
+#define _RANDOM_H_
+
+#include <stdint.h>
+
+#define RNG_XOSHIRO256 1
+#define RNG_SPLITMIX64 2
+
+#ifndef RNG_GENERATOR
+#define RNG_GENERATOR RNG_XOSHIRO256
+#endif
+
+class Random
+{
+	private:
+		uint64_t s[4];
+		static uint64_t splitmix64(uint64_t *x);
+		static uint64_t rotl(uint64_t x, int k) { return((x << k) | (x >> (64 - k))); }
+	public:
+		void set_Seed(unsigned long seed, unsigned long realization, unsigned long stream);
+		void get_State(uint64_t *state);
+		void set_State(const uint64_t *state);
+		uint64_t next(void);
+		float get_Uniform(void) { return((float)(this->next() >> 40)*(1.0f/16777216.0f)); }
+		double get_UniformDouble(void) { return((double)(this->next() >> 11)*(1.0/9007199254740992.0)); }
+		int get_Int(int n);
+		int get_Binomial(int n, double p);
+		double get_Exponential(double rate);
+		Random();
+		~Random(){};
+};
+
+inline uint64_t Random::next(void)
+{
+#if RNG_GENERATOR == RNG_SPLITMIX64
+	return(splitmix64(&this->s[0]));
+#else
+	uint64_t result, t;
+
+	result = rotl(this->s[1]*5,7)*9;
+	t = this->s[1] << 17;
+	this->s[2] ^= this->s[0];
+	this->s[3] ^= this->s[1];
+	this->s[1] ^= this->s[2];
+	this->s[0] ^= this->s[3];
+	this->s[2] ^= t;
+	this->s[3] = rotl(this->s[3],45);
+
+	return(result);
+#endif
+}
+
+inline uint64_t Random::splitmix64(uint64_t *x)
+{
+	uint64_t z;
+
+	z = (*x += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
+
+	return(z ^ (z >> 31));
+}
+
+#endif
@@ -2,23 +2,27 @@
 
 float Site::existence_threshold = 0.0;
 
-Site::Site(int id,int cc)
+Site::Site(int id,int cc,Abundance *ab,int st)
 {
 	this->id = id;
 	this->cc = cc;
-	this->species.clear();
+	this->ab = ab;
+	this->st = st;
 	this->speciesOrdered.clear();
 }
 
 void Site::set_SOC_AvrSpcPar(int sp, float bp, float dp, float mp, float ndp)
 {
+	int i;
+
 	if (sp != -1)
 	{
-		this->soc_Averages.at(sp).bp += bp;	
-		this->soc_Averages.at(sp).dp += dp;	
-		this->soc_Averages.at(sp).ndp += ndp;	
-		this->soc_Averages.at(sp).mp += mp;
-		this->soc_Averages.at(sp).cont++;
+		i = this->ab->ix(this->st,sp);
+		this->ab->soc_bp[i] += bp;	
+		this->ab->soc_dp[i] += dp;	
+		this->ab->soc_ndp[i] += ndp;	
+		this->ab->soc_mp[i] += mp;
+		this->ab->soc_cont[i]++;
 	}
 
 	return;
@@ -28,7 +32,7 @@ float Site::get_SOC_AvrDeathProb(int sp)
 {
 	float dp;
 	
-	dp = this->soc_Averages.at(sp).dp;
+	dp = this->ab->soc_dp[this->ab->ix(this->st,sp)];
 	
 	return(dp);
 }
@@ -37,7 +41,7 @@ float Site::get_SOC_AvrNatDeathProb(int sp)
 {
 	float ndp;
 	
-	ndp = this->soc_Averages.at(sp).ndp;
+	ndp = this->ab->soc_ndp[this->ab->ix(this->st,sp)];
 	
 	return(ndp);
 }
@@ -46,7 +50,7 @@ float Site::get_SOC_AvrBirthProb(int sp)
 {
 	float bp;
 	
-	bp = this->soc_Averages.at(sp).bp;
+	bp = this->ab->soc_bp[this->ab->ix(this->st,sp)];
 	
 	return(bp);
 }
@@ -55,7 +59,7 @@ float Site::get_SOC_AvrMigProb(int sp)
 {
 	float mp;
 	
-	mp = this->soc_Averages.at(sp).mp;
+	mp = this->ab->soc_mp[this->ab->ix(this->st,sp)];
 	
 	return(mp);
 }
@@ -64,11 +68,53 @@ int Site::get_SOC_NumIndChoosed(int sp)
 {
 	int num;
 	
-	num = this->soc_Averages.at(sp).cont;
+	num = this->ab->soc_cont[this->ab->ix(this->st,sp)];
 	
 	return(num);
 }
 
+/*The current SOC rates of the species 'sp' in this site (the last ones calculated by Dynamic::SOC)
+ * */
+float Site::get_BirthProbability(int sp)
+{
+	return(this->ab->rate_bp[this->ab->ix(this->st,sp)]);
+}
+
+float Site::get_DeathProbability(int sp)
+{
+	return(this->ab->rate_dp[this->ab->ix(this->st,sp)]);
+}
+
+float Site::get_NaturalDeathProbability(int sp)
+{
+	return(this->ab->rate_ndp[this->ab->ix(this->st,sp)]);
+}
+
+float Site::get_MigrationProbability(int sp)
+{
+	return(this->ab->rate_mp[this->ab->ix(this->st,sp)]);
+}
+
+int Site::get_SpeciesCC(int sp)
+{
+	return(this->ab->rate_cc[this->ab->ix(this->st,sp)]);
+}
+
+int Site::ver_Birth(int sp, float prob)
+{
+	return(prob < this->get_BirthProbability(sp));
+}
+
+int Site::ver_Death(int sp, float prob)
+{
+	return(prob < this->get_DeathProbability(sp));
+}
+
+int Site::ver_NaturalDeath(int sp, float prob)
+{
+	return(prob < this->get_NaturalDeathProbability(sp));
+}
+
 float Site::get_Density(int sp)
 {
 	int num_IndSpe, total_Ind;
@@ -84,13 +130,7 @@ float Site::get_Density(int sp)
 
 int Site::get_NumberIndSpecies(int sp)
 {
-	int num;
-	
-	num=0;		
-	num+= this->species.at(sp).nOld;
-	num+= this->species.at(sp).nNew;
-	
-	return(num);
+	return(this->ab->nInd[this->ab->ix(this->st,sp)]);
 }
 
 float Site::get_Weight(int sp1, int sp2)
@@ -171,28 +211,24 @@ void Site::set_SpeciesOrdered(int sp,int cont)
 
 void Site::set_ListSpecies(tListSpecies aux, int cont)
 {
-	tSOC_Averages aux_SOC;
-	aux_SOC.bp = 0.0;
-	aux_SOC.dp = 0.0;
-	aux_SOC.ndp = 0.0;
-	aux_SOC.mp = 0.0;
-	aux_SOC.cont = 0;
+	int i;
+
+	i = this->ab->ix(this->st,aux.id - 1);
+	this->ab->site_Version[this->st]++;
+	this->ab->set_Nold(this->st,aux.id - 1,aux.nOld);
+	this->set_Nnew(aux.id - 1,aux.nNew);
+	this->ab->nNew_born[i] = aux.nNew_born;
 	if (cont == 0)
 	{
-		this->species.push_back(aux);
-		this->soc_Averages.push_back(aux_SOC);
-	}
-	else
-	{
-		this->species.at(aux.id - 1).nOld = aux.nOld;
-		this->species.at(aux.id - 1).nNew = aux.nNew;
-		this->species.at(aux.id - 1).nNew_born = aux.nNew_born;
-		this->soc_Averages.at(aux.id - 1).dp = 0.0;
-		this->soc_Averages.at(aux.id - 1).ndp = 0.0;
-		this->soc_Averages.at(aux.id - 1).bp = 0.0;
-		this->soc_Averages.at(aux.id - 1).mp = 0.0;
-		this->soc_Averages.at(aux.id - 1).cont = 0;
+		this->ab->nOld_ini[i] = aux.nOld_ini;
+		this->ab->pref[i] = 0;
+		this->ab->reproductive_exitus[i] = 0.0;
 	}
+	this->ab->soc_dp[i] = 0.0;
+	this->ab->soc_ndp[i] = 0.0;
+	this->ab->soc_bp[i] = 0.0;
+	this->ab->soc_mp[i] = 0.0;
+	this->ab->soc_cont[i] = 0;
 	
 	return;
 }
@@ -211,6 +247,7 @@ void Site::set_Neighborhood(int j, int weight)
 void Site::set_CarryingCapacity(int cc)
 {
 	this->cc = cc;
+	this->ab->site_Version[this->st]++;
 
 	return;
 }
@@ -218,54 +255,53 @@ void Site::set_CarryingCapacity(int cc)
 void Site::set_ReproductiveExitus(int sp,float exitus)
 {
 // 	cerr << "ALE - repExitus: " << exitus << endl; //ALE
-	this->species.at(sp).reproductive_exitus = exitus;
+	int i = this->ab->ix(this->st,sp);
+
+	if (this->ab->reproductive_exitus[i] != exitus) this->ab->site_Version[this->st]++;
+	this->ab->reproductive_exitus[i] = exitus;
 	return;
 }
 
 void Site::set_NoldIni(int sp, int nold_ini)
 {
-	this->species.at(sp).nOld_ini = nold_ini;
+	this->ab->nOld_ini[this->ab->ix(this->st,sp)] = nold_ini;
 
 	return;
 }
 
 void Site::set_NnewBorn(int sp, int nnew_born)
 {
-	this->species.at(sp).nNew_born = nnew_born;
+	this->ab->nNew_born[this->ab->ix(this->st,sp)] = nnew_born;
 
 	return;
 }
 
 void Site::set_Nold(int sp, int nold)
 {
-	this->species.at(sp).nOld = nold;
+	this->ab->set_Nold(this->st,sp,nold);
 	return;
 }
 
 void Site::set_Nnew(int sp, int nnew)
 {
-	this->species.at(sp).nNew = nnew;
+	int i = this->ab->ix(this->st,sp);
+
+	if (this->ab->nNew[i] != nnew) this->ab->site_Version[this->st]++;
+	this->ab->nInd[i] += nnew - this->ab->nNew[i];
+	this->ab->total_Population[this->st] += nnew - this->ab->nNew[i];
+	this->ab->nNew[i] = nnew;
 	return;
 }
 
 void Site::set_Pref(int sp, int pref)
 {
-	this->species.at(sp).pref = pref;
+	this->ab->pref[this->ab->ix(this->st,sp)] = pref;
 	return;
 }
 
 int Site::get_TotalPopulation(void)
 {
-	int sp,sum;
-
-	sum=0;	
-	for (sp=0;sp<(int)this->species.size();sp++)
-	{
-		sum+= this->species.at(sp).nOld;
-		sum+= this->species.at(sp).nNew;
-	}
-
-	return(sum);
+	return(this->ab->total_Population[this->st]);
 }
 
 tNeighborhood Site::get_NeighborhoodData(int st)
@@ -285,32 +321,32 @@ int Site::get_SpeciesOrdered(int sp)
 
 int Site::get_NoldIni(int sp)
 {
-	return(this->species.at(sp).nOld_ini);
+	return(this->ab->nOld_ini[this->ab->ix(this->st,sp)]);
 }
 
 int Site::get_NnewBorn(int sp)
 {
-	return(this->species.at(sp).nNew_born);
+	return(this->ab->nNew_born[this->ab->ix(this->st,sp)]);
 }
 
 int Site::get_Nold(int sp)
 {
-	return(this->species.at(sp).nOld);
+	return(this->ab->nOld[this->ab->ix(this->st,sp)]);
 }
 
 int Site::get_Nnew(int sp)
 {
-	return(this->species.at(sp).nNew);
+	return(this->ab->nNew[this->ab->ix(this->st,sp)]);
 }
 
 float Site::get_ReproductiveExitus(int sp)
 {
-	return(this->species.at(sp).reproductive_exitus);
+	return(this->ab->reproductive_exitus[this->ab->ix(this->st,sp)]);
 }
 
 int Site::get_Pref(int sp)
 {
-	return(this->species.at(sp).pref);
+	return(this->ab->pref[this->ab->ix(this->st,sp)]);
 }
 
 int Site::get_IdSite(void)
@@ -320,7 +356,7 @@ int Site::get_IdSite(void)
 
 int Site::get_IdSpecies(int sp)
 {
-	return(this->species.at(sp).id);
+	return(sp+1);//the species are stored by index (id-1)
 }
 
 int Site::get_NumberNeigh(void)
@@ -335,34 +371,55 @@ int Site::get_NumberSpeciesOrdered(void)
 
 int Site::get_NumberSpecies(void)
 {
-	return(this->species.size());
+	return(this->ab->get_NumberSpecies());
 }
 
 int Site::get_NumberAuxSpecies(void)
 {
-	return(this->aux_ListSpecies.size());
+	return(this->ab->get_NumberPresentSpecies(this->st));
 }
 
 void Site::to_Die(int sp)
 {
-	this->species.at(sp).nOld--;
+	this->ab->set_Nold(this->st,sp,this->ab->nOld[this->ab->ix(this->st,sp)]-1);
 	return;
 }
 
 void Site::to_Born(int sp)
 {
-	this->species.at(sp).nNew++;
-	this->species.at(sp).nNew_born++;
+	int i = this->ab->ix(this->st,sp);
+
+	this->ab->nNew[i]++;
+	this->ab->nNew_born[i]++;
+	this->ab->nInd[i]++;
+	this->ab->site_Version[this->st]++;
+	this->ab->total_Population[this->st]++;
+	return;
+}
+
+/*'n' births at once
+ * */
+void Site::to_Born(int sp, int n)
+{
+	int i = this->ab->ix(this->st,sp);
+
+	this->ab->nNew[i] += n;
+	this->ab->nNew_born[i] += n;
+	this->ab->nInd[i] += n;
+	this->ab->site_Version[this->st]++;
+	this->ab->total_Population[this->st] += n;
 	return;
 }
 
+/*Fisher-Yates shuffle of the species, with the random numbers of the site
+ * */
 void Site::reorder_Species(void)
 {
 	int num,aux,i;
 	
-	for (i=0;i<(int)this->species.size();i++)
+	for (i=(int)this->speciesOrdered.size()-1;i>0;i--)
 	{
-		while((num=random()%this->speciesOrdered.size())==i);
+		num = this->rng.get_Int(i+1);
 		aux = this->speciesOrdered.at(i);
 		this->speciesOrdered.at(i) = this->speciesOrdered.at(num);
 		this->speciesOrdered.at(num) = aux;
@@ -403,81 +460,82 @@ int Site::get_RandSP()
 } 
 */
 
+/*Random choice of one of the species with nOld>0 in the site, all of them with the same probability.
+ * Returns -1 only if there are no species alive in the site.
+ * */
 int Site::get_RandSP()
 {
- int cantSpecies=this->MCdata.size();
-	int r=-1, maxIntentos=cantSpecies, intentos=0;
+	int cantSpecies;
 	int rta=-1;
-	float rnd=(float)(random()%PRECISION)/PRECISION;
-	r=floor(rnd*cantSpecies);
-// 	cerr << "ALE - r: " << r << " cantSP: " << cantSpecies << " rnd: " << rnd << endl;
-	while((MCdata.at(r) < 1) && (intentos++ < maxIntentos))
-	{
-	 rnd=(float)(random()%PRECISION)/PRECISION;
-		r=floor(rnd*cantSpecies);
-// 		r=floor(((random()%PRECISION)/PRECISION)*cantSpecies);
-	}
-	if(MCdata.at(r))
+
+	cantSpecies = this->ab->get_NumberPresentSpecies(this->st);
+	if (cantSpecies > 0)
 	{
-		rta=r;
-		MCdata.at(r)--;
+		rta = this->ab->get_PresentSpecies(this->st,this->rng.get_Int(cantSpecies));
 	}
 	return(rta);
 }
 
+/*Random choice of one prey of 'pred' in the site, with probability nOld(prey)/sum(nOld of the preys of 'pred').
+ * Returns -1 if there are no individuals of the preys.
+ * */
+int Site::get_RandomPrey(int pred)
+{
+	int sumOld;
+
+	sumOld = this->ab->get_NumberIndPreys(this->st,pred);
+	if (sumOld <= 0) return(-1);
 
-int Site::get_RandomSpecies(int cont, int sumOld, vector<int> index)//Following a Multinomial Distribution
+	return(this->ab->get_Prey(this->st,pred,this->rng.get_Int(sumOld)));
+}
+
+Random* Site::get_Random(void)
 {
-	int i;
-	float r, Pc, ref;
-	vector<float> Pi;
-	float sumPi,sumN;
-
-	Pi.assign(this->species.size(),0);	
-	sumPi=0;
-	sumN=0;
-	if (index.size() == 0)//if there is no individuals of this species, then returns -1
-	{
-		return(-1);
-	}
-	for (i=0;i<(int)index.size();i++)
-	{
-		Pi.at(index.at(i)-1) = (float)this->species.at(index.at(i)-1).nOld/sumOld;
-		sumPi +=Pi.at(index.at(i)-1);
-		sumN +=this->species.at(index.at(i)-1).nOld;
-	}
-	Pc=0.0;
-	r = (float)(random()%PRECISION)/PRECISION;
-	for (i=0;i<(int)index.size();i++)
-	{
-		ref = (Pc + Pi.at(index.at(i)-1));
-		if ((Pc <= r) && (r <= ref))
-		{
-			break;
-		}
-		Pc+=Pi.at(index.at(i)-1);
-	}
-	
-	return(index.at(i)-1);
+	return(&this->rng);
 }
 
-int Site::calculate_SumOld(void)
+/*When the Site is copied to another Dynamic (see Dynamic::copy_Structure) it must use the Abundance of that Dynamic
+ * */
+void Site::set_Abundance(Abundance *ab)
 {
-	int sumOld,i;
+	this->ab = ab;
+	return;
+}
 
-	sumOld =0;	
-	this->aux_ListSpecies.clear();
-	this->MCdata.clear(); //ALE
-	for (i=0;i<(int)this->species.size();i++)
-	{
-		if (this->species.at(i).nOld > 0)
-		{
-			this->aux_ListSpecies.push_back(this->species.at(i).id);
-			sumOld+= this->species.at(i).nOld;
-			this->MCdata.push_back( this->species.at(i).nOld ); //ALE
-		}
-		else this->MCdata.push_back( 0 ); //ALE
-	}
-	
-	return(sumOld);
+float Site::get_RandomProbability(void)
+{
+	return(this->rng.get_Uniform());
+}
+
+/*nOld of all the species of the site, kept up to date by Abundance::set_Nold
+ * */
+int Site::get_SumOld(void)
+{
+	return(this->ab->get_SumOld(this->st));
+}
+
+/*The state of the site that is not in the Abundance: the carrying capacity, the order of the species and the random numbers
+ * */
+void Site::save_State(Checkpoint *cp)
+{
+	vector<uint64_t> state(4);
+
+	this->rng.get_State(&state[0]);
+	cp->write_Int(this->cc);
+	cp->write_Vector(this->speciesOrdered);
+	cp->write_Vector(state);
+
+	return;
+}
+
+void Site::load_State(Checkpoint *cp)
+{
+	vector<uint64_t> state;
+
+	this->cc = cp->read_Int();
+	cp->read_Vector(this->speciesOrdered);
+	cp->read_Vector(state);
+	if (state.size() == 4) this->rng.set_State(&state[0]);
+
+	return;
 }
@@ -1,12 +1,17 @@
 //Class Site, that contains:
 //- id - a numerical unique identification
-//- species - a list of Species that exist in the Site, with the following information about them:
-//	- id - identification of the specie
+//- st - the row of the site in the Abundance matrix 'ab', shared by all the sites, where the information about the
+//  species of the site is stored (see Abundance.h):
 //	- nOld - number of individuals from the species at the begining of the iteration
 //	- nNew - number of new individuals from the species, borned at the iteration.
 //	- pref - number that characterize how much the species 'like' to live in this site (#ofpreys - #ofpredators)
-//- neighborhood - neighborhood sites, represented by a list of identification numbers.
+//	- nInd and total_Population - nOld+nNew of each species and of all of them, kept up to date by every method
+//	  that changes nOld or nNew
+//	- the SOC averages
+//- cc - the carrying capacity of the site
+//- neigh - neighborhood sites, represented by a list of identification numbers.
 //- speciesOrdered - list with the indexes of the species that exists in the site. The indexes are ordered randomly in order to define the sequence of migration
+//- rng - the stream of random numbers of the site
 
 /***************************************************************************
  *            Site.h
@@ -46,15 +51,11 @@
 #include <vector>
 #include <stdlib.h>
 #include <stdio.h>
+#include "Abundance.h"
+#include "Random.h"
 
 using namespace::std;
 
-typedef struct sSOC_Averages
-{
-	int cont;
-	float dp,bp,mp,ndp;
-}tSOC_Averages;
-
 typedef struct sNeighborhood
 {
 	int id;
@@ -76,16 +77,15 @@ class Site
 {
 	private:
 		int id;
+		int st;//row of the site in the Abundance matrix
 		int cc;//carrying capacity of the site
-		vector<tListSpecies> species;
+		Abundance *ab;//nOld, nNew, pref... of the species of all the sites
 		vector<tNeighborhood> neigh;
 		vector<int> speciesOrdered;
-		vector<tSOC_Averages> soc_Averages;
+		Random rng;
 	public:
 		static float existence_threshold;
-		vector<int> aux_ListSpecies;
-		vector<int> MCdata;
-		int calculate_SumOld(void);
+		int get_SumOld(void);
 		void set_SpeciesOrdered(int sp,int cont);
 		void set_ListSpecies(tListSpecies aux,int cont);
 		void set_Nold(int,int);
@@ -102,6 +102,14 @@ class Site
 		float get_SOC_AvrBirthProb(int);
 		float get_SOC_AvrMigProb(int);
 		int get_SOC_NumIndChoosed(int);
+		float get_BirthProbability(int);
+		float get_DeathProbability(int);
+		float get_NaturalDeathProbability(int);
+		float get_MigrationProbability(int);
+		int get_SpeciesCC(int);
+		int ver_Birth(int,float);
+		int ver_Death(int,float);
+		int ver_NaturalDeath(int,float);
 		float get_Weight(int sp1, int sp2);
 		float get_Density(int sp);
 		int get_StepFunctionCoexistence(int sp1, int sp2);
@@ -128,9 +136,15 @@ class Site
 		tNeighborhood get_NeighborhoodData(int);
 		void to_Die(int);
 		void to_Born(int);
-		int get_RandomSpecies(int, int, vector<int>);
+		void to_Born(int sp, int n);
 		int get_RandSP();
-		Site(int id,int cc);
+		int get_RandomPrey(int);
+		Random* get_Random(void);
+		void set_Abundance(Abundance *ab);
+		void save_State(Checkpoint *cp);
+		void load_State(Checkpoint *cp);
+		float get_RandomProbability(void);
+		Site(int id,int cc,Abundance *ab,int st);
 		~Site(){};
 };
 
@@ -172,3 +172,28 @@ int Species::get_NumberPreys(void)
 {
 	return(this->preys.size());
 }
+
+/*The parameters (data) and the individuals in time of the realizations, the food web is not written
+ * */
+void Species::save_State(Checkpoint *cp)
+{
+	vector<tData> aux(1,this->data);
+
+	cp->write_Vector(aux);
+	cp->write_Vector(this->total_IndividualsInTime);
+	cp->write_Vector(this->num_IterationsWithIndInTime);
+
+	return;
+}
+
+void Species::load_State(Checkpoint *cp)
+{
+	vector<tData> aux;
+
+	cp->read_Vector(aux);
+	if (aux.size() == 1) this->data = aux.at(0);
+	cp->read_Vector(this->total_IndividualsInTime);
+	cp->read_Vector(this->num_IterationsWithIndInTime);
+
+	return;
+}
@@ -45,6 +45,7 @@
 #include <sstream>
 #include <cmath>
 #include <vector>
+#include "Checkpoint.h"
 
 //Debug variables
 #define it_beg 0
@@ -100,6 +101,8 @@ class Species
 		void set_NaturalDeathProbability(float val);
 		void set_MigrationProbability(float val);
 		void set_NumberInitialIndividuals(int val);
+		void save_State(Checkpoint *cp);
+		void load_State(Checkpoint *cp);
 		Species(int id, float bp, float dp, float ndp, float mp, int nIni, int maxIte);
 		~Species(){};
 };
@@ -0,0 +1,180 @@
+#include "Sweep.h"
+
+Sweep::Sweep(int niter, int tm, int tcn, int seed, char *fwnf, char *snnf, int show_each, int save_each, char *name_Design) : Driver(niter,tm,tcn,seed,fwnf,snnf,show_each,save_each)
+{
+	this->name_Design.assign(name_Design);
+	this->nValues = 0;
+}
+
+Sweep::~Sweep()
+{
+	this->parameters.clear();
+	this->points.clear();
+}
+
+void Sweep::read_Design(void)
+{
+	ifstream f1;
+	string name;
+	tSweepParameter aux;
+
+	f1.open(this->name_Design.c_str());
+	if (!f1.is_open())
+	{
+		cerr << "FILE " << this->name_Design << " DOESN'T EXIST!" << endl;
+		exit(1);
+	}
+	f1 >> name >> this->design >> this->nValues;
+	f1 >> name;
+	while(f1 >> aux.sp >> aux.p >> aux.min >> aux.max)
+	{
+		aux.sp--;//the file has the id of the species
+		if ((aux.sp < 0) || (aux.sp >= (int)this->structure->get_NumberSpeciesFoodWeb()) || (aux.p < 1) || (aux.p > 5))
+		{
+			cerr << "WRONG PARAMETER IN " << this->name_Design << ": SPECIES " << aux.sp+1 << " PARAMETER " << aux.p << endl;
+			exit(1);
+		}
+		if ((aux.p < 4) || ((aux.p == 4) && (Dynamic::default_Engine != ENGINE_MEANFIELD)))//the SOC calculates them from the densities
+		{
+			cerr << "PARAMETER " << aux.p << " OF SPECIES " << aux.sp+1 << " IN " << this->name_Design << " IS CALCULATED BY THE SOC AT EACH ITERATION: ALL THE POINTS WOULD BE THE SAME!" << endl;
+			exit(1);
+		}
+		this->parameters.push_back(aux);
+	}
+	f1.close();
+	if ((this->nValues < 1) || (this->parameters.size() == 0))
+	{
+		cerr << "THE DESIGN " << this->name_Design << " HAS NO POINTS!" << endl;
+		exit(1);
+	}
+
+	return;
+}
+
+/*All the combinations of nValues values of each parameter (the last parameter changes faster)
+ * */
+void Sweep::build_Grid(void)
+{
+	int i,k,n,nPar,idx;
+	float v;
+	vector<float> point;
+
+	nPar = (int)this->parameters.size();
+	n = 1;
+	for (i=0;i<nPar;i++) n *= this->nValues;
+	point.assign(nPar,0.0);
+	for (k=0;k<n;k++)
+	{
+		idx = k;
+		for (i=nPar-1;i>=0;i--)
+		{
+			if (this->nValues > 1) v = (float)(idx % this->nValues)/(this->nValues-1);
+			else v = 0.0;
+			point.at(i) = this->parameters.at(i).min + v*(this->parameters.at(i).max - this->parameters.at(i).min);
+			idx /= this->nValues;
+		}
+		this->points.push_back(point);
+	}
+
+	return;
+}
+
+/*nValues points, each parameter with one point in each of its nValues strata (random order, random
+ * position inside the stratum)
+ * */
+void Sweep::build_LatinHypercube(void)
+{
+	int i,k,j,aux,nPar;
+	float v;
+	vector<int> strata;
+	Random rng;
+
+	nPar = (int)this->parameters.size();
+	rng.set_Seed(this->seed,0,SWEEP_STREAM);
+	this->points.assign(this->nValues,vector<float>(nPar,0.0));
+	strata.assign(this->nValues,0);
+	for (i=0;i<nPar;i++)
+	{
+		for (k=0;k<this->nValues;k++) strata.at(k) = k;
+		for (k=this->nValues-1;k>0;k--)//Fisher-Yates
+		{
+			j = rng.get_Int(k+1);
+			aux = strata.at(k);
+			strata.at(k) = strata.at(j);
+			strata.at(j) = aux;
+		}
+		for (k=0;k<this->nValues;k++)
+		{
+			v = (strata.at(k) + rng.get_Uniform())/this->nValues;
+			this->points.at(k).at(i) = this->parameters.at(i).min + v*(this->parameters.at(i).max - this->parameters.at(i).min);
+		}
+	}
+
+	return;
+}
+
+int Sweep::get_NumberPoints(void)
+{
+	return(this->points.size());
+}
+
+void Sweep::run(void)
+{
+	int k,i,sp;
+	ofstream f1;
+	ostringstream os1;
+
+	this->load_Structure();
+	this->read_Design();
+	if (this->design == "grid") this->build_Grid();
+	else if (this->design == "lhs") this->build_LatinHypercube();
+	else
+	{
+		cerr << "WRONG DESIGN: " << this->design << "! IT MUST BE grid OR lhs" << endl;
+		exit(1);
+	}
+	os1 << "Sweep_seed_" << this->seed << ".dat";
+	f1.open(os1.str().c_str());
+	f1 << "#POINT";
+	for (i=0;i<(int)this->parameters.size();i++) f1 << " SP" << this->parameters.at(i).sp+1 << "_PAR" << this->parameters.at(i).p;
+	f1 << " LAST_ALL_ALIVE";
+	for (sp=0;sp<this->structure->get_NumberSpeciesFoodWeb();sp++) f1 << " IND_SP" << sp+1;
+	f1 << endl;
+	cerr << "RUNNING " << this->get_NumberPoints() << " POINTS OF THE DESIGN " << this->name_Design << " (" << this->design << ")" << endl;
+#pragma omp parallel for schedule(dynamic)
+	for (k=0;k<this->get_NumberPoints();k++)//each point is independent of the others
+	{
+		this->run_Point(k,&f1);
+	}
+	f1.close();
+
+	return;
+}
+
+/*To run the point k and to write its line in 'out'
+ * */
+void Sweep::run_Point(int k, ostream *out)
+{
+	int i;
+	ostringstream line;
+	vector<int> summary;
+	Dynamic *d1;
+
+	d1 = this->new_Run(this->seed);
+	for (i=0;i<(int)this->parameters.size();i++)
+	{
+		d1->set_ParameterSpecies(this->parameters.at(i).p,this->parameters.at(i).sp,this->points.at(k).at(i));
+	}
+	this->run_Summary(d1,&summary);
+	line << k;
+	for (i=0;i<(int)this->parameters.size();i++) line << " " << this->points.at(k).at(i);
+	for (i=0;i<(int)summary.size();i++) line << " " << summary.at(i);
+	line << endl;
+#pragma omp critical
+	{
+		*out << line.str();
+		out->flush();
+	}
+
+	return;
+}
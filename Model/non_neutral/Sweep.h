@@ -0,0 +1,83 @@
+//Class Sweep, that runs the simulation for many points of the space of parameters of the species, in
+//only one process:
+//- the food web (FWNF) and the landscape (SNNF) are read only once (see Driver.h)
+//- the points are run at the same time by a pool of threads (OpenMP, OMP_NUM_THREADS), all of them
+//  with the same SEED
+//- each point writes one line in Sweep_seed_<SEED>.dat, when it finishes:
+//  POINT VALUES... LAST_ITERATION_ALL_ALIVE INDIVIDUALS_SP1 ... INDIVIDUALS_SPn (Driver::run_Summary).
+//  The points don't write any other output file.
+//
+//The design file is:
+//
+//*Design grid 5           (or "lhs 100")
+//*Parameters
+//1 5 20 80               (species id, parameter, minimum, maximum)
+//3 5 10 100
+//
+//The parameters have the same codes of Dynamic::SpaceOfParameters: 1 - birth, 2 - death, 3 - natural death,
+//4 - migration, 5 - number of initial individuals. The SOC calculates 1, 2, 3 and 4 from the densities at each
+//iteration, so a design with them is rejected (4 is only accepted with ENGINE_MEANFIELD, that uses the migration of
+//the species).
+//- grid N - N values for each parameter, from the minimum to the maximum (N^#parameters points)
+//- lhs N  - N points of a Latin Hypercube: for each parameter the interval is divided in N strata
+//           and each stratum is used by only one point (chosen with the stream of Random that
+//           no site uses: (SEED, 0, SWEEP_STREAM))
+
+/***************************************************************************
+ *            Sweep.h
+ *
+ *  Copyright  2009  User Charles Novaes de Santana & Alejandro Rozenfeld
+ *  Email charles.santana@gmail.com / alex@ifisc.uib-csic.es
+ ****************************************************************************/
+
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef _SWEEP_H_
+#define _SWEEP_H_
+
+#include "Driver.h"
+
+#define SWEEP_STREAM 0xFFFFFFFFUL
+
+typedef struct sSweepParameter
+{
+	int sp;//index of the species (id-1)
+	int p;//parameter (codes of SpaceOfParameters)
+	float min;
+	float max;
+}tSweepParameter;
+
+class Sweep : public Driver
+{
+	private:
+		string name_Design;
+		string design;//grid or lhs
+		int nValues;//values of each parameter (grid) or number of points (lhs)
+		vector<tSweepParameter> parameters;
+		vector< vector<float> > points;//the values of the parameters of each point
+		void read_Design(void);
+		void build_Grid(void);
+		void build_LatinHypercube(void);
+		void run_Point(int k, ostream *out);
+	public:
+		int get_NumberPoints(void);
+		void run(void);
+		Sweep(int niter, int tm, int tcn, int seed, char *fwnf, char *snnf, int show_each, int save_each, char *name_Design);
+		~Sweep();
+};
+
+#endif
@@ -0,0 +1,64 @@
+//fwab2dat - to write the binary file of the time series (OUTPUT_BINARY) as the text files of print_File,
+//one per species (output_species_NNN_seed_S_real_R_changes_C.dat), or to print one species.
+//
+//Charles Novaes de Santana
+//Alejandro Rozenfeld
+//
+
+#include "AbundanceReader.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+
+int main(int argc, char **argv)
+{
+	AbundanceReader r1;
+	int k,sp,st,sp_Only;
+	ofstream f1;
+
+	if ((argc != 2) && (argc != 3))
+	{
+		cout << "Incorrect Use!" << endl << endl;
+		cout << "To use:   ./fwab2dat FILE.fwab [SPECIES]" << endl << endl
+		     << "FILE.fwab - Binary file of the time series (output_species_seed_S_real_R_changes_C.fwab)" << endl
+		     << "SPECIES   - (optional) id of the species to print in the standard output, with the iteration in the first column" << endl
+		     << endl;
+		exit(1);
+	}
+	if (!r1.open(argv[1]))
+	{
+		cerr << "FILE " << argv[1] << " IS NOT A VALID BINARY FILE!" << endl;
+		exit(1);
+	}
+	cerr << r1.get_NumberSpecies() << " SPECIES, " << r1.get_NumberSites() << " SITES, " << r1.get_NumberSamples() << " SAMPLES, SEED " << r1.get_Seed() << endl;
+	if (argc == 3)
+	{
+		sp_Only = atoi(argv[2])-1;
+		for (k=0;k<r1.get_NumberSamples();k++)
+		{
+			cout << r1.get_Iteration(k);
+			for (st=0;st<r1.get_NumberSites();st++) cout << " " << r1.get_Individuals(k,sp_Only,st);
+			cout << endl;
+		}
+		return(0);
+	}
+	for (sp=0;sp<r1.get_NumberSpecies();sp++)
+	{
+		ostringstream os1;
+		os1 << "output_species_";
+		os1.width(3);
+		os1.fill('0');
+		os1 << sp+1;
+		os1 << "_seed_" << r1.get_Seed() << "_real_" << r1.get_Realization() << "_changes_" << r1.get_Changes() << ".dat";
+		f1.open(os1.str().c_str());
+		for (k=0;k<r1.get_NumberSamples();k++)
+		{
+			for (st=0;st<r1.get_NumberSites();st++) f1 << r1.get_Individuals(k,sp,st) << " ";
+			f1 << endl;
+		}
+		f1.close();
+	}
+
+	return(0);
+}
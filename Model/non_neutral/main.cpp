@@ -4,48 +4,93 @@
 //Alejandro Rozenfeld
 //
 
-#include "Dynamic.h"
+#include "Ensemble.h"
+#include "Sweep.h"
+#include "EngineCheck.h"
 
 int main(int argc, char **argv)
 {
-	int i,j;
+	Ensemble *e1;
+	Sweep *s1;
+	EngineCheck *c1;
+	int bad,engine;
+	int resume,first;
 
-	if (argc != 10)
+	if ((argc == 5) && (string(argv[1]) == "compile"))//to write the binary form of a food web or a landscape
+	{
+		if ((string(argv[2]) != "fw") && (string(argv[2]) != "snn"))
+		{
+			cerr << "THE KIND OF NETWORK MUST BE 'fw' OR 'snn'!" << endl;
+			exit(1);
+		}
+		return(NetworkFile::compile(argv[3],argv[4],(string(argv[2]) == "fw") ? NETWORK_FOODWEB : NETWORK_LANDSCAPE) ? 0 : 1);
+	}
+	if ((argc > 10) && (Dynamic::get_Migration(argv[argc-1])))//the mode of Migration of all the runs, as the last argument
+	{
+		Dynamic::default_Migration = Dynamic::get_Migration(argv[argc-1]);
+		argc--;
+	}
+	if ((argc > 10) && (Dynamic::get_Engine(argv[argc-1])))//the engine of all the runs, as the last argument (before the mode of Migration)
+	{
+		Dynamic::default_Engine = Dynamic::get_Engine(argv[argc-1]);
+		argc--;
+	}
+	if ((argc < 10) || (argc > 13))
 	{
 		cout << "Incorrect Use!" << endl << endl;
-		cout << "To use:   ./FoodWeb NITE FWNF SNNF TM TCN SEED SHOW-EACH SAVE-EACH EXIST_THR" << endl << endl
+		cout << "To use:   ./FoodWeb NITE FWNF SNNF TM TCN SEED SHOW-EACH SAVE-EACH EXIST_THR [resume] [NSEEDS [SEED-STEP]] [ENGINE] [MIGRATION]" << endl
+		     << "      or: ./FoodWeb NITE FWNF SNNF TM TCN SEED SHOW-EACH SAVE-EACH EXIST_THR sweep DESIGN [ENGINE] [MIGRATION]" << endl
+		     << "      or: ./FoodWeb NITE FWNF SNNF TM TCN SEED SHOW-EACH SAVE-EACH EXIST_THR check tauleap|gillespie|meanfield NSEEDS [MIGRATION]" << endl
+		     << "      or: ./FoodWeb compile fw|snn FILE.net FILE.netb" << endl << endl
 		     << "NITE      - Number of Iterations" << endl
-		     << "FWNF      - Food-Web Network File" << endl
-		     << "SNNF      - Spatial Neighborhood Network File" << endl
+		     << "FWNF      - Food-Web Network File (text, or binary written by 'compile fw')" << endl
+		     << "SNNF      - Spatial Neighborhood Network File (text, or binary written by 'compile snn')" << endl
 		     << "TM        - Time for Migration" << endl
 		     << "TCN       - Time for Generate Coexistence Networks" << endl
 		     << "SEED      - Seed for Random Function" << endl
 		     << "SHOW-EACH - Time for Output" << endl
-		     << "SAVE-EACH - Time for Partial Saved File" << endl
+		     << "SAVE-EACH - Time for Partial Saved File (and for the checkpoint of the run)" << endl
 		     << "EXIST_THR - Minimal threshold above which the species is considered as alive in the site." << endl
+		     << "resume    - (optional) To continue the runs from their checkpoints (checkpoint_seed_<SEED>.chk)" << endl
+		     << "NSEEDS    - (optional) Number of seeds to run at the same time: SEED, SEED+SEED-STEP, ... Each one writes in the directory seed_<SEED>" << endl
+		     << "SEED-STEP - (optional) Difference between two consecutive seeds (default 1)" << endl
+		     << "DESIGN    - File with the points of the space of parameters to run (see Sweep.h)" << endl
+		     << "check     - To compare an engine with the exact one in NSEEDS seeds (see EngineCheck.h)" << endl
+		     << "ENGINE    - (optional) exact (default), tauleap, gillespie or meanfield (see Dynamic.h)" << endl
+		     << "MIGRATION - (optional) sequential (default) or twophase, the flows of all the sites at the same time (see Dynamic.h)" << endl
 
 		     << endl;
 		exit(1);
 	}	
 	Site::existence_threshold = atof(argv[9]);//initializing the minimal threshold above which the species is considered as alive in the site.
 	
-	for (j=0;j<CHANGES_IN_PARAMETERS;j++) // changes in the parameters
-	{	
-		srand(atoi(argv[6]));
-		Dynamic *d1 = new Dynamic(atoi(argv[1]),atof(argv[4]), atoi(argv[5]), atoi(argv[6]), argv[2], argv[3], atoi(argv[7]),atoi(argv[8]));
-		for(i=1;i<=REALIZATIONS;i++)
+	if ((argc == 12) && (string(argv[10]) == "sweep"))//exploration of the space of parameters
+	{
+		s1 = new Sweep(atoi(argv[1]),atof(argv[4]), atoi(argv[5]), atoi(argv[6]), argv[2], argv[3], atoi(argv[7]),atoi(argv[8]),argv[11]);
+		s1->run();
+		delete(s1);
+		return(0);
+	}
+	if ((argc == 13) && (string(argv[10]) == "check"))//an engine against the exact one
+	{
+		engine = Dynamic::get_Engine(argv[11]);
+		if ((!engine) || (engine == ENGINE_EXACT))
 		{
-			cerr << "Run the Monte Carlo (" << i << ")!" << endl;
-			d1->init_Components(i-1);
-			d1->MonteCarlo(i,j);
+			cerr << "THE ENGINE TO CHECK MUST BE 'tauleap', 'gillespie' OR 'meanfield'!" << endl;
+			exit(1);
 		}
-		if (j==0) d1->sufix.assign("par0_var0_Null");
-		cerr << "PRINTING THE REALIZATION " << i-1 << " OF THE SPACE OF PARAMETERS " << j << endl;
-		d1->print_TimeSeriesAtIteration(i-1,j);
-		d1->print_FoodWeb(i-1,j);
-		d1->print_StabilityAnalisys(i-1,j);
-		delete(d1);
+		c1 = new EngineCheck(atoi(argv[1]),atof(argv[4]), atoi(argv[5]), atoi(argv[6]), argv[2], argv[3], atoi(argv[7]),atoi(argv[8]),atoi(argv[12]),engine);
+		bad = c1->run();
+		delete(c1);
+		return(bad ? 1 : 0);
 	}
+	resume = ((argc > 10) && (string(argv[10]) == "resume"));
+	first = 10 + resume;//the first optional argument after 'resume'
+	e1 = new Ensemble(atoi(argv[1]),atof(argv[4]), atoi(argv[5]), atoi(argv[6]), argv[2], argv[3], atoi(argv[7]),atoi(argv[8]));
+	e1->set_Resume(resume);
+	if (argc > first) e1->set_Seeds(atoi(argv[first]), (argc > first+1) ? atoi(argv[first+1]) : 1);
+	e1->run();
+	delete(e1);
 	
 	return(0);
 }
@@ -3,20 +3,17 @@
 #!/bin/bash 
 seed=17
 #seed=1007
+nseeds=2
+step=10
+rm -Rf seed_*
 rm SOC*.dat
 rm erro
 rm AverIndInTime*.dat
 rm FoodWeb_seed*.net
-rm realMig*.dat
 touch erro
 #tail -f erro &
-#50 realizations
-while [  $seed -lt 37 ]; do
-	echo The seed is $seed
-#while [  $seed -lt 50 ]; do
-# 	rm SOC*.dat
-#	rm out*.dat
-#	rm over*.net
+#50 realizations: nseeds=50, step=1
+#All the seeds run in the same process (one thread each, OMP_NUM_THREADS threads), each one in its own directory seed_<seed>
 
 #NITE      - Number of Iterations
 #FWNF      - Food-Web Network File
@@ -27,11 +24,9 @@ while [  $seed -lt 37 ]; do
 #SHOW-EACH - Time for Output
 #SAVE-EACH - Time for Partial Saved File
 #EXIST_THR - Minimal threshold above which the species is considered as alive in the site.	
-#./fweb 101 fwf.net snnf.net 1 2000 $seed 1 100 0.05 2> erro > /dev/null #&
-./fweb 1001 fwf.net snnf.net 1 2000 $seed 2 500 0.05 2> erro > /dev/null #&
-#./fweb 1000 fwf.net snnf.net 1 2000 $seed 1 1000 0.05 2>> erro > /dev/null &
+#NSEEDS    - Number of seeds: SEED, SEED+SEED-STEP, ...
+#SEED-STEP - Difference between two consecutive seeds
+#./fweb 101 fwf.net snnf.net 1 2000 $seed 1 100 0.05 $nseeds $step 2> erro > /dev/null #&
+./fweb 1001 fwf.net snnf.net 1 2000 $seed 2 500 0.05 $nseeds $step 2> erro > /dev/null #&
+#./fweb 1000 fwf.net snnf.net 1 2000 $seed 1 1000 0.05 $nseeds $step 2>> erro > /dev/null &
 # tail -f erro
-	seed=$((seed+10)) 
-done
-
-